@@ -0,0 +1,242 @@
+#include "bdrcancapture.h"
+
+BDRCANCapture::BDRCANCapture() {
+    reset();
+}
+
+bool BDRCANCapture::addTrigger(const CanMessage& signal, CaptureTriggerKind kind, float threshold) {
+    if (triggerCount >= MAX_TRIGGERS || kind == TRIGGER_BITS || kind == TRIGGER_MANUAL) return false;
+    Trigger& t = triggers[triggerCount++];
+    memset(&t, 0, sizeof(t));
+    t.signal = &signal;
+    t.id = signal.id;
+    t.kind = kind;
+    t.threshold = threshold;
+    return true;
+}
+
+bool BDRCANCapture::addBitTrigger(uint32_t id, uint8_t byteIndex, uint8_t mask) {
+    if (triggerCount >= MAX_TRIGGERS || byteIndex >= BDRCANLib::defmeslen || mask == 0) return false;
+    Trigger& t = triggers[triggerCount++];
+    memset(&t, 0, sizeof(t));
+    t.id = id;
+    t.kind = TRIGGER_BITS;
+    t.byteIndex = byteIndex;
+    t.mask = mask;
+    return true;
+}
+
+#if BDRCAN_INVERTER_FEEDBACK
+bool BDRCANCapture::addFaultTriggers() {
+    // The 0x31 limit flags are bits 0-7 of its first byte
+    if (triggerCount + 2 > MAX_TRIGGERS) return false;
+    addTrigger(fault_code, TRIGGER_CHANGE);
+    addBitTrigger(capacitor_temp_limit.id, 0, 0xFF);
+    return true;
+}
+#endif
+
+void BDRCANCapture::clearTriggers() {
+    triggerCount = 0;
+}
+
+void BDRCANCapture::setWindow(uint16_t preFrames, uint16_t postFrames) {
+    // Room for the pre-trigger frames, the trigger frame and the post-trigger frames
+    if (postFrames > RING_FRAMES - 1) postFrames = RING_FRAMES - 1;
+    if (preFrames > RING_FRAMES - 1 - postFrames) preFrames = RING_FRAMES - 1 - postFrames;
+    this->preFrames = preFrames;
+    this->postFrames = postFrames;
+}
+
+void BDRCANCapture::setWindowTime(uint32_t preUs, uint32_t postUs) {
+    this->preUs = preUs;
+    this->postUs = postUs;
+}
+
+void BDRCANCapture::onCapture(CaptureHandler handler, void* context) {
+    this->handler = handler;
+    handlerContext = context;
+}
+
+bool BDRCANCapture::record(const messageStruct& msg, uint8_t bus) {
+    return record(msg, bus, micros());
+}
+
+bool BDRCANCapture::record(const messageStruct& msg, uint8_t bus, uint32_t nowUs) {
+    if (held) {
+        stats.missed++;
+        return false;
+    }
+    CaptureFrame& slot = ring[written & RING_MASK];
+    slot.msg = msg;
+    slot.bus = bus;
+    slot.timestampUs = nowUs;
+    written++;
+    if (filled < RING_FRAMES) filled++;
+    stats.recorded++;
+    return checkTriggers(slot);
+}
+
+bool BDRCANCapture::record(const CANMessage& frame, uint8_t bus) {
+    return record(frame, bus, micros());
+}
+
+bool BDRCANCapture::record(const CANMessage& frame, uint8_t bus, uint32_t nowUs) {
+    if (held) {
+        stats.missed++;
+        return false;
+    }
+    // Straight into the slot, without a messageStruct in between
+    CaptureFrame& slot = ring[written & RING_MASK];
+    slot.msg.id = frame.id;
+    slot.msg.length = (frame.len > 8) ? 8 : frame.len;
+    memcpy(slot.msg.data, frame.data, 8);
+    slot.bus = bus;
+    slot.timestampUs = nowUs;
+    written++;
+    if (filled < RING_FRAMES) filled++;
+    stats.recorded++;
+    return checkTriggers(slot);
+}
+
+bool BDRCANCapture::checkTriggers(const CaptureFrame& slot) {
+    // A frame that starts a capture is its trigger frame, not a post-trigger frame
+    bool postTrigger = state == POST_TRIGGER;
+    bool handed = false;
+    for (int i = 0; i < triggerCount; i++) {
+        Trigger& t = triggers[i];
+        if (t.id != slot.msg.id) continue;
+
+        bool hit = false;
+        float value = 0;
+        if (t.kind == TRIGGER_BITS) {
+            if (t.byteIndex >= slot.msg.length) continue;
+            uint8_t bits = slot.msg.data[t.byteIndex] & t.mask;
+            uint8_t rising = bits & ~t.lastBits;
+            hit = t.known && rising != 0;
+            value = rising;
+            t.lastBits = bits;
+        } else {
+            int64_t raw;
+            if (!BDRCANLib::extractRaw(slot.msg, *t.signal, &raw)) continue;
+            value = BDRCANLib::scaleRaw(raw, *t.signal);
+            hit = t.known && ((t.kind == TRIGGER_CHANGE && value != t.last)
+                              || (t.kind == TRIGGER_ABOVE && t.last <= t.threshold && value > t.threshold)
+                              || (t.kind == TRIGGER_BELOW && t.last >= t.threshold && value < t.threshold));
+            t.last = value;
+        }
+        t.known = true;
+
+        if (hit) {
+            // The trigger frame is the newest one in the ring
+            triggerIndex = written - 1;
+            handed |= fire(t.kind, t.signal, t.id, value, slot.timestampUs);
+        }
+    }
+
+    if (postTrigger && state == POST_TRIGGER) {
+        postCount++;
+        if (postCount >= postFrames || (postUs != 0 && slot.timestampUs - captured.triggerUs >= postUs)) {
+            return finish();
+        }
+    }
+    return handed;
+}
+
+bool BDRCANCapture::update(const OBD2Response& response, uint32_t nowUs) {
+    if (held || response.definition == nullptr || response.count == 0) return false;
+
+    bool handed = false;
+    for (int i = 0; i < triggerCount; i++) {
+        Trigger& t = triggers[i];
+        if (t.signal != response.definition) continue;
+
+        float value = response.values[0];
+        bool hit = t.known && ((t.kind == TRIGGER_CHANGE && value != t.last)
+                               || (t.kind == TRIGGER_ABOVE && t.last <= t.threshold && value > t.threshold)
+                               || (t.kind == TRIGGER_BELOW && t.last >= t.threshold && value < t.threshold));
+        t.last = value;
+        t.known = true;
+
+        if (hit) {
+            // No frame of its own: the capture splits after the newest frame
+            triggerIndex = written;
+            handed |= fire(t.kind, t.signal, response.pid, value, nowUs);
+        }
+    }
+    return handed;
+}
+
+bool BDRCANCapture::trigger(uint32_t nowUs) {
+    if (held) return false;
+    triggerIndex = written;
+    return fire(TRIGGER_MANUAL, nullptr, 0, 0, nowUs);
+}
+
+bool BDRCANCapture::fire(uint8_t kind, const CanMessage* signal, uint32_t id, float value, uint32_t triggerUs) {
+    if (state == POST_TRIGGER) {
+        captured.suppressed++;
+        stats.suppressed++;
+        return false;
+    }
+
+    // Pre-trigger window: back from the trigger while frames are in the ring and in the window
+    uint32_t available = filled - (written - triggerIndex);
+    uint32_t back = 0;
+    while (back < available && back < preFrames) {
+        if (preUs != 0 && triggerUs - ring[(triggerIndex - back - 1) & RING_MASK].timestampUs > preUs) break;
+        back++;
+    }
+
+    captureStart = triggerIndex - back;
+    postCount = 0;
+    captured.triggerUs = triggerUs;
+    captured.kind = kind;
+    captured.signal = signal;
+    captured.id = id;
+    captured.value = value;
+    captured.frames = 0;
+    captured.triggerFrame = (uint16_t)back;
+    captured.suppressed = 0;
+    state = POST_TRIGGER;
+
+    if (postFrames == 0) return finish();
+    return false;
+}
+
+bool BDRCANCapture::finish() {
+    captured.frames = (uint16_t)(written - captureStart);
+    state = ARMED;
+    stats.captures++;
+    if (handler != nullptr) handler(*this, captured, handlerContext);
+    return true;
+}
+
+bool BDRCANCapture::update() {
+    return update(micros());
+}
+
+bool BDRCANCapture::update(uint32_t nowUs) {
+    if (state != POST_TRIGGER || postUs == 0) return false;
+    if (nowUs - captured.triggerUs < postUs) return false;
+    return finish();
+}
+
+void BDRCANCapture::release() {
+    held = false;
+}
+
+void BDRCANCapture::reset() {
+    memset(ring, 0, sizeof(ring));
+    memset(&captured, 0, sizeof(captured));
+    memset(&stats, 0, sizeof(stats));
+    written = 0;
+    filled = 0;
+    state = ARMED;
+    held = false;
+    postCount = 0;
+    for (int i = 0; i < triggerCount; i++) {
+        triggers[i].known = false;
+        triggers[i].lastBits = 0;
+    }
+}
@@ -0,0 +1,163 @@
+/*
+    bdrcancapture.h - Pre/post-trigger capture of raw CAN traffic around faults.
+
+    Every frame goes into a fixed RAM ring with its receive time, always on. When a trigger
+    fires (fault_code changes, a 0x31 limit flag trips, a signal crosses a threshold), the
+    frames before it are frozen as the pre-trigger window, recording goes on for the
+    post-trigger window, and the whole capture is handed to a handler, e.g. the SD logger,
+    straight out of the ring. Recording is one slot write per frame, plus a compare per
+    trigger on the frame's ID.
+    */
+
+    #ifndef bdrcancapture_h
+    #define bdrcancapture_h
+    #include "Arduino.h"
+    #include <ACAN_T4.h>
+    #include "bdrcanlib.h"
+    #include "bdrcanisotp.h"
+
+    struct CaptureFrame {
+        messageStruct msg;
+        uint8_t bus;                // as passed to record(), e.g. 1 for can1, 2 for can2
+        uint32_t timestampUs;       // micros() at record()
+    };
+
+    enum CaptureTriggerKind : uint8_t {
+        TRIGGER_CHANGE,             // decoded value differs from the previous one
+        TRIGGER_ABOVE,              // decoded value rises above threshold
+        TRIGGER_BELOW,              // decoded value falls below threshold
+        TRIGGER_BITS,               // a masked bit of one data byte goes from 0 to 1
+        TRIGGER_MANUAL              // trigger() was called
+    };
+
+    struct CaptureInfo {
+        uint32_t triggerUs;         // receive time of the trigger frame
+        uint8_t kind;               // CaptureTriggerKind that fired
+        const CanMessage* signal;   // trigger signal, nullptr for TRIGGER_BITS / TRIGGER_MANUAL
+        uint32_t id;                // trigger frame ID
+        float value;                // decoded value (TRIGGER_BITS: the bits that went high)
+        uint16_t frames;            // frames in the capture
+        uint16_t triggerFrame;      // index of the trigger frame; frames before it are pre-trigger
+        uint16_t suppressed;        // triggers that fired again during the post-trigger window
+    };
+
+    struct CaptureStats {
+        uint32_t recorded;          // frames written to the ring
+        uint32_t captures;          // captures handed to the handler
+        uint32_t suppressed;        // triggers ignored: capture in progress or held
+        uint32_t missed;            // frames not recorded while a capture was held
+    };
+
+    class BDRCANCapture {
+    public:
+        typedef void (*CaptureHandler)(const BDRCANCapture& capture, const CaptureInfo& info, void* context);
+
+        BDRCANCapture();
+
+        // Trigger on a decoded signal; returns false if the trigger table is full
+        bool addTrigger(const CanMessage& signal, CaptureTriggerKind kind, float threshold = 0);
+
+        // Trigger when any bit of mask in data[byteIndex] of frame id goes high
+        bool addBitTrigger(uint32_t id, uint8_t byteIndex, uint8_t mask);
+
+#if BDRCAN_INVERTER_FEEDBACK
+        // fault_code changes, or any 0x31 limit flag trips
+        bool addFaultTriggers();
+#endif
+
+        void clearTriggers();
+
+        // Window sizes; 0 in a time limit means frames only. The pre-trigger window, the
+        // trigger frame and the post-trigger window must fit the ring, so frames are clamped.
+        void setWindow(uint16_t preFrames, uint16_t postFrames);
+        void setWindowTime(uint32_t preUs, uint32_t postUs);
+
+        // Record a frame and check the triggers; returns true if a capture was handed over
+        bool record(const messageStruct& msg, uint8_t bus = 0);
+        bool record(const messageStruct& msg, uint8_t bus, uint32_t nowUs);
+        bool record(const CANMessage& frame, uint8_t bus);
+        bool record(const CANMessage& frame, uint8_t bus, uint32_t nowUs);
+
+        // Check triggers on a reassembled BMS response (no frame is recorded)
+        bool update(const OBD2Response& response, uint32_t nowUs);
+
+        // Close a post-trigger time window on a quiet bus; call from loop()
+        bool update();
+        bool update(uint32_t nowUs);
+
+        // Start a capture at the newest frame
+        bool trigger(uint32_t nowUs);
+
+        // Called once the post-trigger window is complete; the capture is read in place
+        void onCapture(CaptureHandler handler, void* context = nullptr);
+
+        // The capture being handed over, oldest first; valid in the handler, or until release()
+        int captureCount() const { return captured.frames; }
+        const CaptureFrame& captureFrame(int i) const { return ring[(captureStart + i) & RING_MASK]; }
+
+        // From the handler: keep the capture frozen after it returns, e.g. while a slow writer
+        // drains it. Recording stops until release(); frames in between count as missed.
+        void hold() { held = true; }
+        void release();
+
+        bool isCapturing() const { return state == POST_TRIGGER; }
+        bool isHeld() const { return held; }
+
+        const CaptureStats& getStats() const { return stats; }
+        void reset();
+
+        static const int RING_FRAMES = 512;
+        static const int MAX_TRIGGERS = 8;
+        static const uint16_t DEFAULT_PRE_FRAMES = 256;
+        static const uint16_t DEFAULT_POST_FRAMES = 128;
+
+    private:
+        static const uint32_t RING_MASK = RING_FRAMES - 1;
+        static_assert((RING_FRAMES & RING_MASK) == 0, "RING_FRAMES must be a power of two");
+
+        struct Trigger {
+            const CanMessage* signal;   // nullptr for bit triggers
+            uint32_t id;
+            uint8_t kind;
+            uint8_t byteIndex;
+            uint8_t mask;
+            uint8_t lastBits;
+            float threshold;
+            float last;
+            bool known;                 // last holds a value
+        };
+
+        enum State : uint8_t {
+            ARMED,
+            POST_TRIGGER
+        };
+
+        bool checkTriggers(const CaptureFrame& slot);
+        bool fire(uint8_t kind, const CanMessage* signal, uint32_t id, float value, uint32_t triggerUs);
+        bool finish();
+
+        CaptureFrame ring[RING_FRAMES];
+        uint32_t written = 0;           // frames ever written; the newest is written - 1
+        uint16_t filled = 0;            // frames in the ring, up to RING_FRAMES
+
+        Trigger triggers[MAX_TRIGGERS];
+        uint8_t triggerCount = 0;
+
+        uint16_t preFrames = DEFAULT_PRE_FRAMES;
+        uint16_t postFrames = DEFAULT_POST_FRAMES;
+        uint32_t preUs = 0;
+        uint32_t postUs = 0;
+
+        State state = ARMED;
+        bool held = false;
+        uint32_t triggerIndex = 0;      // written index of the trigger frame
+        uint32_t captureStart = 0;
+        uint16_t postCount = 0;
+        CaptureInfo captured;
+
+        CaptureHandler handler = nullptr;
+        void* handlerContext = nullptr;
+        CaptureStats stats;
+    };
+
+#endif
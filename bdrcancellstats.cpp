@@ -0,0 +1,209 @@
+#include "Arduino.h"
+#include "bdrcanconfig.h"
+
+// Built only when the profile includes the signals this module reads
+#if BDRCAN_BMS_CELLS
+#include "bdrcancellstats.h"
+
+BDRCANCellStats::BDRCANCellStats(uint8_t cellsPerModule)
+    : cellsPerModule(cellsPerModule ? cellsPerModule : CELLS_PER_FRAME) {
+    reset();
+}
+
+void BDRCANCellStats::reset() {
+    memset(channels, 0, sizeof(channels));
+    memset(balancing, 0, sizeof(balancing));
+    for (int ch = 0; ch < CHANNEL_COUNT; ch++) {
+        memset(channels[ch].minTree, NO_CELL, sizeof(channels[ch].minTree));
+        memset(channels[ch].maxTree, NO_CELL, sizeof(channels[ch].maxTree));
+    }
+
+    // Physical units come from the first definition of each array
+    channels[CELL_VOLTAGE].scale = cell_voltages_1_12.scale;
+    channels[OPENCELL_VOLTAGE].scale = opencell_voltages_1_12.scale;
+    channels[INTERNAL_RESISTANCE].scale = internal_resistances_1_12.scale;
+}
+
+void BDRCANCellStats::setPopulatedCells(uint8_t count) {
+    populatedLimit = (count > CELL_COUNT) ? CELL_COUNT : count;
+    for (int ch = 0; ch < CHANNEL_COUNT; ch++) {
+        for (int cell = populatedLimit; cell < CELL_COUNT; cell++) {
+            removeCell(channels[ch], cell);
+        }
+    }
+}
+
+bool BDRCANCellStats::update(const OBD2Response& response) {
+    return update(response.pid, response.data, response.length);
+}
+
+bool BDRCANCellStats::update(uint16_t pid, const uint8_t* data, uint8_t length) {
+    // Each array is one PID page, 15 frames of 12 cells
+    int channel;
+    uint16_t page = pid & 0xFF00;
+    if (page == (cell_voltages_1_12.id & 0xFF00)) channel = CELL_VOLTAGE;
+    else if (page == (opencell_voltages_1_12.id & 0xFF00)) channel = OPENCELL_VOLTAGE;
+    else if (page == (internal_resistances_1_12.id & 0xFF00)) channel = INTERNAL_RESISTANCE;
+    else return false;
+
+    int frame = pid & 0xFF;
+    if (frame >= CELL_COUNT / CELLS_PER_FRAME || data == nullptr) return false;
+
+    int first = frame * CELLS_PER_FRAME;
+    int count = length / 2;
+    if (count > CELLS_PER_FRAME) count = CELLS_PER_FRAME;
+
+    ChannelState& state = channels[channel];
+    for (int i = 0; i < count; i++) {
+        int cell = first + i;
+        uint16_t value = (data[2 * i] << 8) | data[2 * i + 1];
+
+        // Internal resistance MSB is the balancing flag, not part of the value
+        if (channel == INTERNAL_RESISTANCE) {
+            if (value & 0x8000) balancing[cell / 32] |= 1UL << (cell % 32);
+            else balancing[cell / 32] &= ~(1UL << (cell % 32));
+            value &= 0x7FFF;
+        }
+
+        if (cell < populatedLimit) setCell(state, cell, value);
+    }
+    return true;
+}
+
+void BDRCANCellStats::setCell(ChannelState& state, int cell, uint16_t value) {
+    uint32_t bit = 1UL << (cell % 32);
+    int module = cell / cellsPerModule;
+
+    if (state.seen[cell / 32] & bit) {
+        uint16_t old = state.raw[cell];
+        if (old == value) return;
+        state.sum -= old;
+        state.sumSquares -= (uint32_t)old * old;
+        state.moduleRaw[module] -= old;
+    } else {
+        state.seen[cell / 32] |= bit;
+        state.populated++;
+        state.minTree[TREE_LEAVES + cell] = cell;
+        state.maxTree[TREE_LEAVES + cell] = cell;
+    }
+
+    state.raw[cell] = value;
+    state.sum += value;
+    state.sumSquares += (uint32_t)value * value;
+    state.moduleRaw[module] += value;
+    replay(state, cell);
+}
+
+void BDRCANCellStats::removeCell(ChannelState& state, int cell) {
+    uint32_t bit = 1UL << (cell % 32);
+    if (!(state.seen[cell / 32] & bit)) return;
+
+    uint16_t old = state.raw[cell];
+    state.seen[cell / 32] &= ~bit;
+    state.populated--;
+    state.sum -= old;
+    state.sumSquares -= (uint32_t)old * old;
+    state.moduleRaw[cell / cellsPerModule] -= old;
+    state.raw[cell] = 0;
+    state.minTree[TREE_LEAVES + cell] = NO_CELL;
+    state.maxTree[TREE_LEAVES + cell] = NO_CELL;
+    replay(state, cell);
+}
+
+// Re-run the matches on the path from a leaf to the root: log2(TREE_LEAVES) steps
+void BDRCANCellStats::replay(ChannelState& state, int cell) {
+    for (int node = (TREE_LEAVES + cell) >> 1; node >= 1; node >>= 1) {
+        state.minTree[node] = winner(state, state.minTree[2 * node], state.minTree[2 * node + 1], true);
+        state.maxTree[node] = winner(state, state.maxTree[2 * node], state.maxTree[2 * node + 1], false);
+    }
+}
+
+uint8_t BDRCANCellStats::winner(const ChannelState& state, uint8_t a, uint8_t b, bool lowest) {
+    if (a == NO_CELL) return b;
+    if (b == NO_CELL) return a;
+    if (state.raw[a] == state.raw[b]) return (a < b) ? a : b;
+    return ((state.raw[a] < state.raw[b]) == lowest) ? a : b;
+}
+
+CellSummary BDRCANCellStats::summary(Channel channel) const {
+    const ChannelState& state = channels[channel];
+    CellSummary result;
+    memset(&result, 0, sizeof(result));
+    result.minCell = NO_CELL;
+    result.maxCell = NO_CELL;
+    if (state.populated == 0) return result;
+
+    uint32_t n = state.populated;
+    result.populated = n;
+    result.minCell = state.minTree[1];
+    result.maxCell = state.maxTree[1];
+    result.min = state.raw[result.minCell] * state.scale;
+    result.max = state.raw[result.maxCell] * state.scale;
+    result.imbalance = result.max - result.min;
+    result.mean = (float)state.sum / n * state.scale;
+
+    // n^2 * variance, exact in integers: no cancellation from the running sums
+    uint64_t spread = (uint64_t)n * state.sumSquares - (uint64_t)state.sum * state.sum;
+    result.stddev = (float)(sqrt((double)spread) / n) * state.scale;
+    return result;
+}
+
+int BDRCANCellStats::lowest(Channel channel, uint8_t* cells, int n) const {
+    return topN(channels[channel], true, cells, n);
+}
+
+int BDRCANCellStats::highest(Channel channel, uint8_t* cells, int n) const {
+    return topN(channels[channel], false, cells, n);
+}
+
+// Best-first walk down the tournament tree: each node's winner is the best cell below it,
+// so the n best cells come out in order after visiting about n * log2(TREE_LEAVES) nodes
+int BDRCANCellStats::topN(const ChannelState& state, bool lowestFirst, uint8_t* cells, int n) const {
+    const uint8_t* tree = lowestFirst ? state.minTree : state.maxTree;
+    if (n > MAX_TOP_N) n = MAX_TOP_N;
+    if (tree[1] == NO_CELL || n <= 0) return 0;
+
+    uint16_t candidates[MAX_TOP_N * 9 + 1];
+    int candidateCount = 0;
+    candidates[candidateCount++] = 1;
+
+    int written = 0;
+    while (written < n && candidateCount > 0) {
+        int best = 0;
+        for (int i = 1; i < candidateCount; i++) {
+            if (winner(state, tree[candidates[i]], tree[candidates[best]], lowestFirst) == tree[candidates[i]]) {
+                best = i;
+            }
+        }
+        uint16_t node = candidates[best];
+        candidates[best] = candidates[--candidateCount];
+
+        if (node >= TREE_LEAVES) {
+            cells[written++] = tree[node];
+            continue;
+        }
+        for (uint16_t child = 2 * node; child <= 2 * node + 1; child++) {
+            if (tree[child] != NO_CELL && candidateCount < (int)(sizeof(candidates) / sizeof(candidates[0]))) {
+                candidates[candidateCount++] = child;
+            }
+        }
+    }
+    return written;
+}
+
+float BDRCANCellStats::moduleSum(Channel channel, int module) const {
+    if (module < 0 || module >= (CELL_COUNT + cellsPerModule - 1) / cellsPerModule) return 0.0f;
+    return channels[channel].moduleRaw[module] * channels[channel].scale;
+}
+
+float BDRCANCellStats::cellValue(Channel channel, int cell) const {
+    if (cell < 0 || cell >= CELL_COUNT) return 0.0f;
+    return channels[channel].raw[cell] * channels[channel].scale;
+}
+
+bool BDRCANCellStats::isBalancing(int cell) const {
+    if (cell < 0 || cell >= CELL_COUNT) return false;
+    return (balancing[cell / 32] >> (cell % 32)) & 1;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+    bdrcancellstats.h - Incremental pack statistics over the 180-cell Orion arrays.
+
+    Each 12-cell array response (cell_voltages_*, opencell_voltages_*, internal_resistances_*)
+    updates running sums and a min / max tournament tree in place, so a frame costs
+    O(12 log n) and the pack summary is O(1) to read.
+    */
+
+    #ifndef bdrcancellstats_h
+    #define bdrcancellstats_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    #if !(BDRCAN_BMS_CELLS)
+    #error "bdrcancellstats.h needs BDRCAN_BMS_CELLS enabled in bdrcanconfig.h"
+    #endif
+    #include "bdrcanisotp.h"
+
+    struct CellSummary {
+        uint16_t populated;         // cells reported at least once
+        float min;                  // lowest cell (V or mOhm)
+        float max;                  // highest cell
+        float mean;                 // average cell
+        float stddev;               // population standard deviation
+        float imbalance;            // max - min
+        uint8_t minCell;            // index of the lowest cell (0 = cell 1)
+        uint8_t maxCell;            // index of the highest cell
+    };
+
+    class BDRCANCellStats {
+    public:
+        enum Channel {
+            CELL_VOLTAGE,
+            OPENCELL_VOLTAGE,
+            INTERNAL_RESISTANCE,
+            CHANNEL_COUNT
+        };
+
+        BDRCANCellStats(uint8_t cellsPerModule = CELLS_PER_FRAME);
+
+        // Ignore cells at or above this index (Orion reports unpopulated cells as 0)
+        void setPopulatedCells(uint8_t count);
+
+        // Feed an array response: PID 0xF100-0xF30E, payload after the 0x62 / PID header.
+        // Returns false if the PID is not a cell array.
+        bool update(uint16_t pid, const uint8_t* data, uint8_t length);
+        bool update(const OBD2Response& response);
+
+        // Pack summary, O(1)
+        CellSummary summary(Channel channel) const;
+
+        // The n lowest / highest cells, best first; returns how many were written
+        int lowest(Channel channel, uint8_t* cells, int n) const;
+        int highest(Channel channel, uint8_t* cells, int n) const;
+
+        // Sum of one module's cells (module size set in the constructor), O(1)
+        float moduleSum(Channel channel, int module) const;
+
+        // Latest value of one cell, 0 if never reported
+        float cellValue(Channel channel, int cell) const;
+
+        // Balancing flag carried in the MSB of the internal resistance arrays
+        bool isBalancing(int cell) const;
+
+        void reset();
+
+        static const int CELL_COUNT = 180;
+        static const int CELLS_PER_FRAME = 12;
+        static const int MAX_TOP_N = 16;
+
+    private:
+        // Tournament tree over the cells: node k holds the winning cell of its subtree,
+        // leaves start at TREE_LEAVES
+        static const int TREE_LEAVES = 256;
+        static const uint8_t NO_CELL = 0xFF;
+
+        struct ChannelState {
+            uint16_t raw[CELL_COUNT];
+            uint8_t minTree[2 * TREE_LEAVES];
+            uint8_t maxTree[2 * TREE_LEAVES];
+            uint32_t moduleRaw[CELL_COUNT];
+            uint32_t seen[(CELL_COUNT + 31) / 32];
+            uint32_t sum;
+            uint64_t sumSquares;
+            uint16_t populated;
+            float scale;
+        };
+
+        void setCell(ChannelState& state, int cell, uint16_t value);
+        void removeCell(ChannelState& state, int cell);
+        void replay(ChannelState& state, int cell);
+        int topN(const ChannelState& state, bool lowestFirst, uint8_t* cells, int n) const;
+        static uint8_t winner(const ChannelState& state, uint8_t a, uint8_t b, bool lowest);
+
+        ChannelState channels[CHANNEL_COUNT];
+        uint32_t balancing[(CELL_COUNT + 31) / 32];
+        uint8_t cellsPerModule;
+        uint8_t populatedLimit = CELL_COUNT;
+    };
+
+#endif
@@ -0,0 +1,76 @@
+/*
+    bdrcanconfig.h - Compile-time build profile: which parts of the signal table are built in.
+
+    Every switch can be set here or with a build flag (-DBDRCAN_BMS_CELLS=0 in PlatformIO
+    build_flags, or the Teensy boards.txt extra flags). Switched-off groups are not compiled:
+    their CanMessage globals, table entries, ID index slots and the modules that depend on them
+    all disappear from flash and RAM.
+    */
+
+    #ifndef bdrcanconfig_h
+    #define bdrcanconfig_h
+
+    // Presets: pick one, then override single switches if needed
+    #define BDRCAN_PROFILE_FULL 0           // every signal, with descriptions
+    #define BDRCAN_PROFILE_INVERTER 1       // inverter commands and feedback only
+    #define BDRCAN_PROFILE_BMS 2            // Orion BMS PIDs and cell arrays only
+    #define BDRCAN_PROFILE_MINIMAL 3        // inverter feedback only, no descriptions
+
+    #ifndef BDRCAN_PROFILE
+    #define BDRCAN_PROFILE BDRCAN_PROFILE_FULL
+    #endif
+
+    // Group defaults of each preset: commands, feedback, BMS status, BMS cells, descriptions
+    #if BDRCAN_PROFILE == BDRCAN_PROFILE_INVERTER
+    #define BDRCAN_DEFAULT_GROUPS 1, 1, 0, 0, 1
+    #elif BDRCAN_PROFILE == BDRCAN_PROFILE_BMS
+    #define BDRCAN_DEFAULT_GROUPS 0, 0, 1, 1, 1
+    #elif BDRCAN_PROFILE == BDRCAN_PROFILE_MINIMAL
+    #define BDRCAN_DEFAULT_GROUPS 0, 1, 0, 0, 0
+    #else
+    #define BDRCAN_DEFAULT_GROUPS 1, 1, 1, 1, 1
+    #endif
+
+    #define BDRCAN_GROUP_0(a, b, c, d, e) a
+    #define BDRCAN_GROUP_1(a, b, c, d, e) b
+    #define BDRCAN_GROUP_2(a, b, c, d, e) c
+    #define BDRCAN_GROUP_3(a, b, c, d, e) d
+    #define BDRCAN_GROUP_4(a, b, c, d, e) e
+    #define BDRCAN_DEFAULT(pick, groups) pick(groups)
+
+    // Inverter command IDs 0x01-0x0C (Set_*, Max_*, Drive_Enable)
+    #ifndef BDRCAN_INVERTER_COMMANDS
+    #define BDRCAN_INVERTER_COMMANDS BDRCAN_DEFAULT(BDRCAN_GROUP_0, BDRCAN_DEFAULT_GROUPS)
+    #endif
+
+    // Inverter feedback IDs 0x20-0x35 (erpm, voltages, currents, temperatures, flags)
+    #ifndef BDRCAN_INVERTER_FEEDBACK
+    #define BDRCAN_INVERTER_FEEDBACK BDRCAN_DEFAULT(BDRCAN_GROUP_1, BDRCAN_DEFAULT_GROUPS)
+    #endif
+
+    // Orion BMS single-value PIDs 0xF004-0xF04F
+    #ifndef BDRCAN_BMS_STATUS
+    #define BDRCAN_BMS_STATUS BDRCAN_DEFAULT(BDRCAN_GROUP_2, BDRCAN_DEFAULT_GROUPS)
+    #endif
+
+    // Orion BMS 12-cell arrays 0xF100-0xF30E
+    #ifndef BDRCAN_BMS_CELLS
+    #define BDRCAN_BMS_CELLS BDRCAN_DEFAULT(BDRCAN_GROUP_3, BDRCAN_DEFAULT_GROUPS)
+    #endif
+
+    // Long description strings; 0 replaces every description with ""
+    #ifndef BDRCAN_DESCRIPTIONS
+    #define BDRCAN_DESCRIPTIONS BDRCAN_DEFAULT(BDRCAN_GROUP_4, BDRCAN_DEFAULT_GROUPS)
+    #endif
+
+    #if !(BDRCAN_INVERTER_COMMANDS || BDRCAN_INVERTER_FEEDBACK || BDRCAN_BMS_STATUS || BDRCAN_BMS_CELLS)
+    #error "bdrcanconfig.h: at least one signal group must be enabled"
+    #endif
+
+    #if BDRCAN_DESCRIPTIONS
+    #define BDRCAN_DESCRIPTION(text) text
+    #else
+    #define BDRCAN_DESCRIPTION(text) ""
+    #endif
+
+#endif
@@ -0,0 +1,95 @@
+#include "Arduino.h"
+#include "bdrcanconfig.h"
+
+// Built only when the profile includes the signals this module reads
+#if BDRCAN_INVERTER_FEEDBACK && BDRCAN_BMS_STATUS
+#include "bdrcanderived.h"
+
+BDRCANDerived::BDRCANDerived() {
+    reset();
+}
+
+void BDRCANDerived::reset() {
+    memset(&energy, 0, sizeof(energy));
+    memset(&charge, 0, sizeof(charge));
+    voltageMv = 0;
+    currentMa = 0;
+    powerMw = 0;
+    lapStartUj = 0;
+    lastLapUj = 0;
+}
+
+void BDRCANDerived::setMaxGap(uint32_t maxGapUs) {
+    this->maxGapUs = maxGapUs;
+}
+
+bool BDRCANDerived::update(const messageStruct& msg) {
+    return update(msg, micros());
+}
+
+bool BDRCANDerived::update(const messageStruct& msg, uint32_t timestampUs) {
+    if (msg.id == input_voltage.id || msg.id == DC_current.id) {
+        // Power follows whichever half of the product changed last
+        if (msg.id == input_voltage.id) {
+            voltageMv = (int32_t)lroundf(lib.interpretInverterMessage(msg, input_voltage) * 1000.0f);
+        } else {
+            currentMa = (int32_t)lroundf(lib.interpretInverterMessage(msg, DC_current) * 1000.0f);
+        }
+        powerMw = (int32_t)(((int64_t)voltageMv * currentMa) / 1000);
+        energy.add(powerMw, timestampUs, maxGapUs);
+        return true;
+    }
+
+    if (msg.id == signed_pack_current.id) {
+        int32_t packMa = (int32_t)lroundf(lib.interpretBMSMessage(msg, signed_pack_current) * 1000.0f);
+        charge.add(packMa, timestampUs, maxGapUs);
+        return true;
+    }
+
+    return false;
+}
+
+void BDRCANDerived::Integrator::add(int32_t value, uint32_t timestampUs, uint32_t maxGapUs) {
+    if (primed) {
+        // Wrap-safe: micros() rolls over every ~71 minutes
+        uint32_t dt = timestampUs - lastUs;
+        if (dt <= maxGapUs) {
+            // milli-units x us = nano-units x s; halve for the trapezoid, /1000 for micro-units
+            int64_t area = (int64_t)(last + (int64_t)value) * dt + remainder;
+            total += area / 2000;
+            remainder = area % 2000;
+        } else {
+            gaps++;
+        }
+    }
+    last = value;
+    lastUs = timestampUs;
+    primed = true;
+}
+
+float BDRCANDerived::powerW() const {
+    return powerMw / 1000.0f;
+}
+
+float BDRCANDerived::energyWh() const {
+    return energy.total / 3.6e9f;
+}
+
+float BDRCANDerived::lapEnergyWh() const {
+    return (energy.total - lapStartUj) / 3.6e9f;
+}
+
+float BDRCANDerived::lastLapEnergyWh() const {
+    return lastLapUj / 3.6e9f;
+}
+
+void BDRCANDerived::markLap() {
+    lastLapUj = energy.total - lapStartUj;
+    lapStartUj = energy.total;
+}
+
+float BDRCANDerived::amphours() const {
+    return charge.total / 3.6e9f;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+    bdrcanderived.h - Derived channels maintained from received frames.
+
+    DC power (input_voltage x DC_current), energy (total and per lap) and amp-hours
+    (signed_pack_current) are updated on each relevant frame by trapezoidal integration
+    against the receive timestamps. Accumulators are fixed-point, so long sessions do not
+    drift, and every read is O(1).
+    */
+
+    #ifndef bdrcanderived_h
+    #define bdrcanderived_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    #if !(BDRCAN_INVERTER_FEEDBACK && BDRCAN_BMS_STATUS)
+    #error "bdrcanderived.h needs BDRCAN_INVERTER_FEEDBACK and BDRCAN_BMS_STATUS enabled in bdrcanconfig.h"
+    #endif
+
+    class BDRCANDerived {
+    public:
+        BDRCANDerived();
+
+        // Feed every received frame with its receive timestamp; returns true if it was used
+        bool update(const messageStruct& msg, uint32_t timestampUs);
+        bool update(const messageStruct& msg);
+
+        // Latest DC power in watts (negative while regenerating)
+        float powerW() const;
+
+        // Energy since reset() in watt-hours
+        float energyWh() const;
+
+        // Energy since the last markLap(), and over the previous complete lap
+        float lapEnergyWh() const;
+        float lastLapEnergyWh() const;
+        void markLap();
+
+        // Charge since reset() from signed_pack_current, in amp-hours
+        float amphours() const;
+
+        // Raw fixed-point accumulators
+        int64_t energyMicrojoules() const { return energy.total; }
+        int64_t chargeMicrocoulombs() const { return charge.total; }
+
+        // Samples further apart than this are not integrated across (bus dropout)
+        void setMaxGap(uint32_t maxGapUs);
+        uint32_t getGapCount() const { return energy.gaps + charge.gaps; }
+
+        void reset();
+
+        static const uint32_t DEFAULT_MAX_GAP_US = 500000;
+
+    private:
+        // Trapezoidal integrator over milli-unit samples and microsecond timestamps.
+        // total is in micro-units x seconds; remainder carries the truncated part.
+        struct Integrator {
+            int64_t total;
+            int64_t remainder;
+            int32_t last;
+            uint32_t lastUs;
+            uint32_t gaps;
+            bool primed;
+
+            void add(int32_t value, uint32_t timestampUs, uint32_t maxGapUs);
+        };
+
+        BDRCANLib lib;
+        Integrator energy;
+        Integrator charge;
+        int32_t voltageMv = 0;
+        int32_t currentMa = 0;
+        int32_t powerMw = 0;
+        int64_t lapStartUj = 0;
+        int64_t lastLapUj = 0;
+        uint32_t maxGapUs = DEFAULT_MAX_GAP_US;
+    };
+
+#endif
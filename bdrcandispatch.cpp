@@ -0,0 +1,76 @@
+#include "Arduino.h"
+#include "bdrcandispatch.h"
+
+BDRCANDispatcher::BDRCANDispatcher() {
+    memset(frameRoutes, 0, sizeof(frameRoutes));
+    memset(signalRoutes, 0, sizeof(signalRoutes));
+}
+
+bool BDRCANDispatcher::onID(uint32_t id, FrameHandler handler, void* context) {
+    int slot = BDRCANLib::findSlotByID(id);
+    if (slot < 0) return false;
+    frameRoutes[slot].handler = handler;
+    frameRoutes[slot].context = context;
+    frameRoutes[slot].explicitID = (handler != nullptr);
+    refreshDecode(slot);
+    return true;
+}
+
+void BDRCANDispatcher::onDevice(DeviceClass device, FrameHandler handler, void* context) {
+    int slots = BDRCANLib::getSlotCount();
+    for (int slot = 0; slot < slots; slot++) {
+        if (frameRoutes[slot].explicitID) continue;
+        const CanMessage* first = BDRCANLib::getSlotMessages(slot)[0];
+        bool match = (device == DEVICE_INVERTER) ? BDRCANLib::isInverterMessage(first)
+                                                 : BDRCANLib::isBMSMessage(first);
+        if (!match) continue;
+        frameRoutes[slot].handler = handler;
+        frameRoutes[slot].context = context;
+        refreshDecode(slot);
+    }
+}
+
+bool BDRCANDispatcher::onSignal(const CanMessage& definition, SignalHandler handler, void* context) {
+    int index = BDRCANLib::findMessageIndex(&definition);
+    if (index < 0) return false;
+    signalRoutes[index].handler = handler;
+    signalRoutes[index].context = context;
+    refreshDecode(BDRCANLib::findSlotByID(definition.id));
+    return true;
+}
+
+// Only decode a slot when someone is listening to it
+void BDRCANDispatcher::refreshDecode(int slot) {
+    int count;
+    const CanMessage* const* defs = BDRCANLib::getSlotMessages(slot, &count);
+    int first = (int)(defs - BDRCANLib::getAllMessages());
+
+    bool decode = (frameRoutes[slot].handler != nullptr);
+    for (int i = 0; i < count && !decode; i++) {
+        decode = (signalRoutes[first + i].handler != nullptr);
+    }
+    frameRoutes[slot].decode = decode;
+}
+
+bool BDRCANDispatcher::dispatch(const messageStruct& msg) {
+    int slot = BDRCANLib::findSlotByID(msg.id);
+    if (slot < 0 || !frameRoutes[slot].decode) return false;
+
+    DecodedFrame frame;
+    frame.signals = BDRCANLib::getSlotMessages(slot);
+    frame.count = lib.decodeFrame(msg, frame.values, BDRCANLib::MAX_SIGNALS_PER_ID);
+    int first = (int)(frame.signals - BDRCANLib::getAllMessages());
+
+    for (int i = 0; i < frame.count; i++) {
+        const SignalRoute& signal = signalRoutes[first + i];
+        if (signal.handler != nullptr) {
+            signal.handler(*frame.signals[i], frame.values[i], signal.context);
+        }
+    }
+
+    const FrameRoute& route = frameRoutes[slot];
+    if (route.handler != nullptr) {
+        route.handler(msg, frame, route.context);
+    }
+    return true;
+}
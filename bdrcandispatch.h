@@ -0,0 +1,64 @@
+/*
+    bdrcandispatch.h - Per-ID handler dispatch for received frames.
+
+    Handlers are registered per ID, per device class or per signal. Registration resolves
+    everything into a jump table indexed by the ID slot, so dispatching a frame costs one
+    slot lookup and one indirect call, and the handler receives the already-decoded signals.
+    */
+
+    #ifndef bdrcandispatch_h
+    #define bdrcandispatch_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    struct DecodedFrame {
+        const CanMessage* const* signals;   // definitions of every signal carried by the ID
+        float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+        uint8_t count;                      // values decoded; a short frame stops at its DLC
+    };
+
+    class BDRCANDispatcher {
+    public:
+        typedef void (*FrameHandler)(const messageStruct& msg, const DecodedFrame& frame, void* context);
+        typedef void (*SignalHandler)(const CanMessage& definition, float value, void* context);
+
+        enum DeviceClass {
+            DEVICE_INVERTER,
+            DEVICE_BMS
+        };
+
+        BDRCANDispatcher();
+
+        // Handler for one CAN ID; takes precedence over a device class handler
+        bool onID(uint32_t id, FrameHandler handler, void* context = nullptr);
+
+        // Handler for every ID of a device class that has no ID handler of its own
+        void onDevice(DeviceClass device, FrameHandler handler, void* context = nullptr);
+
+        // Handler for one signal, called with its decoded value
+        bool onSignal(const CanMessage& definition, SignalHandler handler, void* context = nullptr);
+
+        // Decode and route a received frame; returns false if nothing handles the ID
+        bool dispatch(const messageStruct& msg);
+
+    private:
+        struct FrameRoute {
+            FrameHandler handler;
+            void* context;
+            bool explicitID;        // set by onID, not overwritten by onDevice
+            bool decode;            // a frame or signal handler needs the decoded values
+        };
+
+        struct SignalRoute {
+            SignalHandler handler;
+            void* context;
+        };
+
+        void refreshDecode(int slot);
+
+        BDRCANLib lib;
+        FrameRoute frameRoutes[BDRCANLib::ID_SLOT_COUNT];
+        SignalRoute signalRoutes[BDRCANLib::MESSAGE_COUNT];
+    };
+
+#endif
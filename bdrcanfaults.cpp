@@ -0,0 +1,197 @@
+#include "Arduino.h"
+#include "bdrcanconfig.h"
+
+// Built only when the profile includes the signals this module reads
+#if BDRCAN_INVERTER_FEEDBACK && BDRCAN_BMS_STATUS
+#include "bdrcanfaults.h"
+
+// Indexed by InverterFault
+static const char* const INVERTER_FAULT_NAMES[INVERTER_FAULT_COUNT] = {
+    "No fault",
+    "Overvoltage",
+    "Undervoltage",
+    "DRV error",
+    "Absolute overcurrent",
+    "Controller overtemperature",
+    "Motor overtemperature",
+    "Sensor wire fault",
+    "Sensor general fault",
+    "CAN command error",
+    "Analog input error"
+};
+
+// Indexed by relays_status bit
+static const char* const RELAY_FLAG_NAMES[16] = {
+    "Discharge relay enabled",
+    "Charge relay enabled",
+    "Charger safety enabled",
+    "Malfunction indicator active",
+    "Multi-purpose input active",
+    "Always-on signal active",
+    "Is-ready signal active",
+    "Is-charging signal active",
+    "Relay status bit 8",
+    "Relay status bit 9",
+    "Relay status bit 10",
+    "Relay status bit 11",
+    "Relay status bit 12",
+    "Relay status bit 13",
+    "Relay status bit 14",
+    "Relay status bit 15"
+};
+
+static const char UNKNOWN_FAULT_NAME[] = "Unknown fault";
+
+BDRCANFaults::BDRCANFaults() {
+    reset();
+}
+
+void BDRCANFaults::reset() {
+    clearJournal();
+    inverterCode = FAULT_NONE;
+    inverterRawCode = FAULT_NONE;
+    relays = 0;
+    relaysKnown = false;
+}
+
+void BDRCANFaults::clearJournal() {
+    memset(journal, 0, sizeof(journal));
+    head = 0;
+    eventCount = 0;
+    dropped = 0;
+}
+
+void BDRCANFaults::setDedupWindow(uint32_t windowMs) {
+    dedupWindowMs = windowMs;
+}
+
+void BDRCANFaults::setRelayJournalMask(uint16_t mask) {
+    relayJournalMask = mask;
+}
+
+InverterFault BDRCANFaults::decodeInverterFault(uint16_t code) {
+    return (code < INVERTER_FAULT_COUNT) ? (InverterFault)code : FAULT_UNKNOWN;
+}
+
+const char* BDRCANFaults::inverterFaultName(InverterFault fault) {
+    return (fault < INVERTER_FAULT_COUNT) ? INVERTER_FAULT_NAMES[fault] : UNKNOWN_FAULT_NAME;
+}
+
+const char* BDRCANFaults::relayFlagName(int bit) {
+    return (bit >= 0 && bit < 16) ? RELAY_FLAG_NAMES[bit] : UNKNOWN_FAULT_NAME;
+}
+
+bool BDRCANFaults::update(const messageStruct& msg) {
+    return update(msg, millis());
+}
+
+bool BDRCANFaults::update(const messageStruct& msg, uint32_t nowMs) {
+    // A short frame does not carry the field: it says nothing about the fault state
+    int64_t raw;
+    if (msg.id == fault_code.id) {
+        if (!BDRCANLib::extractRaw(msg, fault_code, &raw)) return false;
+
+        // Compared raw, so a switch between two unknown codes is a change too
+        uint16_t code = (uint16_t)raw;
+        if (code == inverterRawCode) return false;
+
+        if (inverterRawCode != FAULT_NONE) leave(SOURCE_INVERTER, inverterRawCode, nowMs);
+        if (code != FAULT_NONE) enter(SOURCE_INVERTER, code, nowMs);
+        inverterRawCode = code;
+        inverterCode = decodeInverterFault(code);
+        return true;
+    }
+
+    if (msg.id == relays_status.id) {
+        if (!BDRCANLib::extractRaw(msg, relays_status, &raw)) return false;
+        uint16_t flags = (uint16_t)raw;
+        if (relaysKnown && flags == relays) return false;
+        applyRelays(flags, nowMs);
+        return true;
+    }
+
+    return false;
+}
+
+bool BDRCANFaults::update(const OBD2Response& response) {
+    return update(response, millis());
+}
+
+bool BDRCANFaults::update(const OBD2Response& response, uint32_t nowMs) {
+    if (response.pid != relays_status.id || response.count == 0) return false;
+
+    uint16_t flags = (uint16_t)response.values[0];
+    if (relaysKnown && flags == relays) return false;
+    applyRelays(flags, nowMs);
+    return true;
+}
+
+void BDRCANFaults::applyRelays(uint16_t flags, uint32_t nowMs) {
+    // Only journal bits that changed since the last report
+    uint16_t changed = (flags ^ relays) & relayJournalMask;
+    for (int bit = 0; changed != 0; bit++, changed >>= 1) {
+        if (!(changed & 1)) continue;
+        if (flags & (1U << bit)) enter(SOURCE_RELAYS, bit, nowMs);
+        else leave(SOURCE_RELAYS, bit, nowMs);
+    }
+    relays = flags;
+    relaysKnown = true;
+}
+
+void BDRCANFaults::enter(uint8_t source, uint16_t rawCode, uint32_t nowMs) {
+    // A state that comes back soon after clearing extends its existing entry
+    int slot = findRecent(source, rawCode);
+    if (slot >= 0 && !journal[slot].active && (nowMs - journal[slot].clearedMs) <= dedupWindowMs) {
+        FaultEvent& event = journal[slot];
+        event.lastMs = nowMs;
+        if (event.count < 0xFFFF) event.count++;
+        event.active = true;
+        return;
+    }
+
+    // Ring full: overwrite the oldest entry
+    if (eventCount == JOURNAL_SIZE) {
+        head = (head + 1) % JOURNAL_SIZE;
+        eventCount--;
+        dropped++;
+    }
+
+    FaultEvent& event = journal[(head + eventCount) % JOURNAL_SIZE];
+    event.firstMs = nowMs;
+    event.lastMs = nowMs;
+    event.clearedMs = 0;
+    event.count = 1;
+    event.rawCode = rawCode;
+    event.source = source;
+    event.code = (source == SOURCE_INVERTER) ? (uint8_t)decodeInverterFault(rawCode) : (uint8_t)rawCode;
+    event.active = true;
+    eventCount++;
+}
+
+void BDRCANFaults::leave(uint8_t source, uint16_t rawCode, uint32_t nowMs) {
+    int slot = findRecent(source, rawCode);
+    if (slot < 0 || !journal[slot].active) return;
+    journal[slot].active = false;
+    journal[slot].clearedMs = nowMs;
+}
+
+// Newest entry for this source / code, -1 if it has left the ring
+int BDRCANFaults::findRecent(uint8_t source, uint16_t rawCode) const {
+    for (int i = eventCount - 1; i >= 0; i--) {
+        int slot = (head + i) % JOURNAL_SIZE;
+        if (journal[slot].source == source && journal[slot].rawCode == rawCode) return slot;
+    }
+    return -1;
+}
+
+const FaultEvent& BDRCANFaults::getEvent(int i) const {
+    if (i < 0 || i >= eventCount) i = 0;
+    return journal[(head + i) % JOURNAL_SIZE];
+}
+
+const char* BDRCANFaults::eventName(const FaultEvent& event) const {
+    if (event.source == SOURCE_RELAYS) return relayFlagName(event.code);
+    return inverterFaultName((InverterFault)event.code);
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*
+    bdrcanfaults.h - Table-driven decoding of fault_code and relays_status, with a fault journal.
+
+    The inverter fault code indexes a name table and the BMS relay state is kept as a bitmask,
+    so detecting a change costs one compare per frame. Transitions go into a fixed ring; a fault
+    that keeps coming back within the de-duplication window bumps its existing entry instead of
+    adding a new one.
+    */
+
+    #ifndef bdrcanfaults_h
+    #define bdrcanfaults_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+    #include "bdrcanisotp.h"
+
+    #if !(BDRCAN_INVERTER_FEEDBACK && BDRCAN_BMS_STATUS)
+    #error "bdrcanfaults.h needs BDRCAN_INVERTER_FEEDBACK and BDRCAN_BMS_STATUS enabled in bdrcanconfig.h"
+    #endif
+
+    // fault_code (0x28), DTI CAN manual
+    enum InverterFault : uint8_t {
+        FAULT_NONE = 0x00,
+        FAULT_OVERVOLTAGE = 0x01,
+        FAULT_UNDERVOLTAGE = 0x02,
+        FAULT_DRV = 0x03,
+        FAULT_ABS_OVERCURRENT = 0x04,
+        FAULT_CONTROLLER_OVERTEMP = 0x05,
+        FAULT_MOTOR_OVERTEMP = 0x06,
+        FAULT_SENSOR_WIRE = 0x07,
+        FAULT_SENSOR_GENERAL = 0x08,
+        FAULT_CAN_COMMAND = 0x09,
+        FAULT_ANALOG_INPUT = 0x0A,
+        INVERTER_FAULT_COUNT,
+        FAULT_UNKNOWN = 0xFF            // code outside the table
+    };
+
+    // relays_status (0xF004) bits, Orion BMS 2 PID sheet
+    enum RelayFlag : uint16_t {
+        RELAY_DISCHARGE_ENABLED = 0x0001,
+        RELAY_CHARGE_ENABLED = 0x0002,
+        RELAY_CHARGER_SAFETY = 0x0004,
+        RELAY_MALFUNCTION = 0x0008,
+        RELAY_MULTIPURPOSE_INPUT = 0x0010,
+        RELAY_ALWAYS_ON = 0x0020,
+        RELAY_IS_READY = 0x0040,
+        RELAY_IS_CHARGING = 0x0080
+    };
+
+    struct FaultEvent {
+        uint32_t firstMs;       // first time the state was entered
+        uint32_t lastMs;        // latest time it was entered again
+        uint32_t clearedMs;     // time it was left, valid when !active
+        uint16_t count;         // times entered (de-duplicated repeats)
+        uint16_t rawCode;       // fault_code as received (FAULT_UNKNOWN keeps it), or relay bit index
+        uint8_t source;         // BDRCANFaults::Source
+        uint8_t code;           // InverterFault, or relay bit index
+        bool active;            // still present
+    };
+
+    class BDRCANFaults {
+    public:
+        enum Source : uint8_t {
+            SOURCE_INVERTER,
+            SOURCE_RELAYS
+        };
+
+        BDRCANFaults();
+
+        // Feed frames / responses; returns true if the state changed. Frames too short to carry
+        // the field are ignored.
+        bool update(const messageStruct& msg, uint32_t nowMs);
+        bool update(const messageStruct& msg);
+        bool update(const OBD2Response& response, uint32_t nowMs);
+        bool update(const OBD2Response& response);
+
+        // Current state
+        InverterFault inverterFault() const { return inverterCode; }
+        uint16_t inverterFaultCode() const { return inverterRawCode; }     // raw, also for FAULT_UNKNOWN
+        uint16_t relayFlags() const { return relays; }
+        bool hasRelayFlag(RelayFlag flag) const { return (relays & flag) != 0; }
+
+        // Interned names: the same pointer for the same code, never nullptr
+        static InverterFault decodeInverterFault(uint16_t code);
+        static const char* inverterFaultName(InverterFault fault);
+        static const char* relayFlagName(int bit);
+
+        // Journal, oldest first; index 0 <= i < getEventCount()
+        int getEventCount() const { return eventCount; }
+        const FaultEvent& getEvent(int i) const;
+        const char* eventName(const FaultEvent& event) const;
+        uint32_t getDroppedCount() const { return dropped; }
+
+        // Re-entering a state within this window updates the existing entry
+        void setDedupWindow(uint32_t windowMs);
+
+        // Relay bits that are journaled; defaults to the malfunction indicator and relay states
+        void setRelayJournalMask(uint16_t mask);
+
+        void clearJournal();
+        void reset();
+
+        static const int JOURNAL_SIZE = 32;
+        static const uint32_t DEFAULT_DEDUP_WINDOW_MS = 5000;
+
+    private:
+        void enter(uint8_t source, uint16_t rawCode, uint32_t nowMs);
+        void leave(uint8_t source, uint16_t rawCode, uint32_t nowMs);
+        int findRecent(uint8_t source, uint16_t rawCode) const;
+        void applyRelays(uint16_t flags, uint32_t nowMs);
+
+        FaultEvent journal[JOURNAL_SIZE];
+        uint8_t head = 0;               // slot of the oldest event
+        uint8_t eventCount = 0;
+        uint32_t dropped = 0;
+        uint32_t dedupWindowMs = DEFAULT_DEDUP_WINDOW_MS;
+        uint16_t relayJournalMask = RELAY_DISCHARGE_ENABLED | RELAY_CHARGE_ENABLED | RELAY_MALFUNCTION;
+
+        InverterFault inverterCode = FAULT_NONE;
+        uint16_t inverterRawCode = FAULT_NONE;
+        uint16_t relays = 0;
+        bool relaysKnown = false;
+    };
+
+#endif
@@ -0,0 +1,95 @@
+#include "Arduino.h"
+#include "bdrcanconfig.h"
+
+// Built only when the profile includes the signals this module reads
+#if BDRCAN_INVERTER_FEEDBACK
+#include "bdrcanflags.h"
+
+// Definition behind each bit of the limit word
+static const CanMessage* const LIMIT_SIGNALS[] = {
+    &capacitor_temp_limit,
+    &DC_current_limit,
+    &drive_enable_limit,
+    &igbt_acceleration_temperature_limit,
+    &igbt_temperature_limit,
+    &input_voltage_limit,
+    &motor_acceleration_temperature_limit,
+    &motor_temperature_limit,
+    &RPM_min_limit,
+    &RPM_max_limit,
+    &power_limit
+};
+
+BDRCANFlags::BDRCANFlags() {
+    reset();
+}
+
+void BDRCANFlags::reset() {
+    limitWord = 0;
+    limitRising = 0;
+    limitFalling = 0;
+    inputWord = 0;
+    inputRising = 0;
+    inputFalling = 0;
+}
+
+void BDRCANFlags::onLimitEdge(EdgeHandler handler, void* context) {
+    limitHandler = handler;
+    limitContext = context;
+}
+
+void BDRCANFlags::onInputEdge(EdgeHandler handler, void* context) {
+    inputHandler = handler;
+    inputContext = context;
+}
+
+const char* BDRCANFlags::limitName(int bit) {
+    if (bit < 0 || bit >= (int)(sizeof(LIMIT_SIGNALS) / sizeof(LIMIT_SIGNALS[0]))) return "";
+    return LIMIT_SIGNALS[bit]->name;
+}
+
+uint16_t BDRCANFlags::merge(uint16_t& word, uint8_t frameBits, uint16_t mask, int shift) {
+    uint16_t next = (word & ~(mask << shift)) | ((uint16_t)(frameBits & mask) << shift);
+    uint16_t changed = word ^ next;
+    word = next;
+    return changed;
+}
+
+bool BDRCANFlags::update(const messageStruct& msg) {
+    bool isLimit = (msg.id == capacitor_temp_limit.id || msg.id == RPM_min_limit.id);
+    bool isInput = (msg.id == digital_input_1.id || msg.id == digital_input_1_2.id);
+    if (!isLimit && !isInput) return false;
+
+    if (msg.length < 1) {
+        Serial.println("Error: Message data out of bounds!");
+        return false;
+    }
+
+    if (isLimit) {
+        // 0x31 fills the low byte, 0x32 the three bits above it
+        uint16_t changed = (msg.id == capacitor_temp_limit.id)
+                               ? merge(limitWord, msg.data[0], 0xFF, 0)
+                               : merge(limitWord, msg.data[0], 0x07, 8);
+        limitRising = changed & limitWord;
+        limitFalling = changed & ~limitWord;
+        if (changed && limitHandler != nullptr) {
+            limitHandler(limitRising, limitFalling, limitContext);
+        }
+        return changed != 0;
+    }
+
+    // 0x2E fills the low nibble, 0x2F the high nibble
+    uint16_t word = inputWord;
+    uint16_t changed = (msg.id == digital_input_1.id)
+                           ? merge(word, msg.data[0], 0x0F, 0)
+                           : merge(word, msg.data[0], 0x0F, 4);
+    inputWord = (uint8_t)word;
+    inputRising = changed & inputWord;
+    inputFalling = changed & ~inputWord;
+    if (changed && inputHandler != nullptr) {
+        inputHandler(inputRising, inputFalling, inputContext);
+    }
+    return changed != 0;
+}
+
+#endif
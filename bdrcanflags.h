@@ -0,0 +1,94 @@
+/*
+    bdrcanflags.h - Inverter limit and digital input frames as integer bitmasks.
+
+    The limit frames (0x31, 0x32) and digital input frames (0x2E, 0x2F) carry only one-bit
+    signals. Each frame's first byte is masked straight into a flag word, so no per-signal
+    float decoding is needed, and one XOR against the previous word gives the edges.
+    */
+
+    #ifndef bdrcanflags_h
+    #define bdrcanflags_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    #if !(BDRCAN_INVERTER_FEEDBACK)
+    #error "bdrcanflags.h needs BDRCAN_INVERTER_FEEDBACK enabled in bdrcanconfig.h"
+    #endif
+
+    // Limit word: 0x31 bits 0-7, then 0x32 bits 0-2 (bit_start of each definition)
+    enum LimitFlag : uint16_t {
+        LIMIT_CAPACITOR_TEMP = 1U << 0,         // capacitor_temp_limit
+        LIMIT_DC_CURRENT = 1U << 1,             // DC_current_limit
+        LIMIT_DRIVE_ENABLE = 1U << 2,           // drive_enable_limit
+        LIMIT_IGBT_ACCEL_TEMP = 1U << 3,        // igbt_acceleration_temperature_limit
+        LIMIT_IGBT_TEMP = 1U << 4,              // igbt_temperature_limit
+        LIMIT_INPUT_VOLTAGE = 1U << 5,          // input_voltage_limit
+        LIMIT_MOTOR_ACCEL_TEMP = 1U << 6,       // motor_acceleration_temperature_limit
+        LIMIT_MOTOR_TEMP = 1U << 7,             // motor_temperature_limit
+        LIMIT_RPM_MIN = 1U << 8,                // RPM_min_limit
+        LIMIT_RPM_MAX = 1U << 9,                // RPM_max_limit
+        LIMIT_POWER = 1U << 10,                 // power_limit
+        LIMIT_ALL = 0x07FF
+    };
+
+    // Digital input word: 0x2E bits 0-3, then 0x2F bits 0-3
+    enum DigitalInputFlag : uint8_t {
+        INPUT_1 = 1U << 0,                      // digital_input_1
+        INPUT_2 = 1U << 1,
+        INPUT_3 = 1U << 2,
+        INPUT_4 = 1U << 3,
+        INPUT_1_ALT = 1U << 4,                  // digital_input_1_2
+        INPUT_2_ALT = 1U << 5,
+        INPUT_3_ALT = 1U << 6,
+        INPUT_4_ALT = 1U << 7,
+        INPUT_ALL = 0xFF
+    };
+
+    class BDRCANFlags {
+    public:
+        typedef void (*EdgeHandler)(uint16_t rising, uint16_t falling, void* context);
+
+        BDRCANFlags();
+
+        // Feed any frame; returns true if a limit or input flag changed
+        bool update(const messageStruct& msg);
+
+        // Current flag words
+        uint16_t limits() const { return limitWord; }
+        uint8_t inputs() const { return inputWord; }
+        bool isLimitActive(LimitFlag flag) const { return (limitWord & flag) != 0; }
+        bool isInputHigh(DigitalInputFlag flag) const { return (inputWord & flag) != 0; }
+
+        // Edges from the most recent frame of each kind: engaged / released limits, rising / falling inputs
+        uint16_t limitsEngaged() const { return limitRising; }
+        uint16_t limitsReleased() const { return limitFalling; }
+        uint8_t inputsRising() const { return inputRising; }
+        uint8_t inputsFalling() const { return inputFalling; }
+
+        // Called only when a frame changes its word
+        void onLimitEdge(EdgeHandler handler, void* context = nullptr);
+        void onInputEdge(EdgeHandler handler, void* context = nullptr);
+
+        // Name of one bit of the limit word (as in the CAN manual), "" if unused
+        static const char* limitName(int bit);
+
+        void reset();
+
+    private:
+        // Merge a frame's first byte into the word at shift; returns the changed bits
+        static uint16_t merge(uint16_t& word, uint8_t frameBits, uint16_t mask, int shift);
+
+        uint16_t limitWord = 0;
+        uint16_t limitRising = 0;
+        uint16_t limitFalling = 0;
+        uint8_t inputWord = 0;
+        uint8_t inputRising = 0;
+        uint8_t inputFalling = 0;
+
+        EdgeHandler limitHandler = nullptr;
+        void* limitContext = nullptr;
+        EdgeHandler inputHandler = nullptr;
+        void* inputContext = nullptr;
+    };
+
+#endif
@@ -0,0 +1,149 @@
+#include "Arduino.h"
+#include "bdrcanisotp.h"
+
+BDRCANIsoTp::BDRCANIsoTp(ACAN_T4& bus) : bus(bus) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void BDRCANIsoTp::onResponse(ResponseHandler handler, void* context) {
+    this->handler = handler;
+    handlerContext = context;
+}
+
+void BDRCANIsoTp::setFlowControl(uint8_t blockSize, uint8_t separationTimeMin) {
+    this->blockSize = blockSize;
+    this->separationTimeMin = separationTimeMin;
+}
+
+bool BDRCANIsoTp::handleFrame(const CANMessage& frame) {
+    if (frame.id != RESPONSE_ID || frame.len == 0) return false;
+
+    // Protocol control information: high nibble of byte 0
+    switch (frame.data[0] >> 4) {
+        case 0x0: {
+            // Single frame: whole response in this frame
+            uint8_t length = frame.data[0] & 0x0F;
+            if (length == 0 || length > frame.len - 1) return true;
+            active = false;
+            deliver(&frame.data[1], length);
+            return true;
+        }
+
+        case 0x1: {
+            // First frame: 12-bit total length, then the first 6 bytes
+            uint16_t length = ((frame.data[0] & 0x0F) << 8) | frame.data[1];
+            if (length > MAX_PAYLOAD) {
+                stats.overflows++;
+                active = false;
+                sendFlowControl(FLOW_OVERFLOW);
+                return true;
+            }
+
+            uint8_t chunk = (frame.len > 2) ? frame.len - 2 : 0;
+            if (chunk > length) chunk = length;
+            memcpy(buffer, &frame.data[2], chunk);
+            expected = length;
+            received = chunk;
+            nextSequence = 1;
+            blockRemaining = blockSize;
+            active = true;
+            lastFrameMs = millis();
+            sendFlowControl(FLOW_CONTINUE);
+            return true;
+        }
+
+        case 0x2: {
+            // Consecutive frame: 4-bit sequence number, then up to 7 bytes
+            if (!active) return true;
+            if ((frame.data[0] & 0x0F) != nextSequence) {
+                stats.sequenceErrors++;
+                active = false;
+                return true;
+            }
+
+            uint16_t chunk = (frame.len > 1) ? frame.len - 1 : 0;
+            if (chunk > expected - received) chunk = expected - received;
+            memcpy(&buffer[received], &frame.data[1], chunk);
+            received += chunk;
+            nextSequence = (nextSequence + 1) & 0x0F;
+            lastFrameMs = millis();
+
+            if (received >= expected) {
+                active = false;
+                deliver(buffer, expected);
+            } else if (blockSize != 0 && --blockRemaining == 0) {
+                // End of block: the BMS waits for the next flow control
+                blockRemaining = blockSize;
+                sendFlowControl(FLOW_CONTINUE);
+            }
+            return true;
+        }
+
+        default:
+            // Flow control addressed to a sender; this side only receives
+            return true;
+    }
+}
+
+void BDRCANIsoTp::update() {
+    if (flowControlPending) {
+        stats.flowControlRetries++;
+        sendFlowControl(pendingStatus);
+    }
+
+    if (active && (millis() - lastFrameMs) > TIMEOUT_MS) {
+        stats.timeouts++;
+        active = false;
+        flowControlPending = false;
+    }
+}
+
+bool BDRCANIsoTp::sendFlowControl(uint8_t status) {
+    CANMessage frame;
+    frame.id = FLOW_CONTROL_ID;
+    frame.ext = false;
+    frame.len = 8;
+
+    // Flow control format:
+    // Byte 0: 0x30 continue to send / 0x32 overflow
+    // Byte 1: Block size (0 = send everything)
+    // Byte 2: Minimum separation time in ms
+    // Bytes 3-7: Padding (0x00)
+    memset(frame.data, 0, 8);
+    frame.data[0] = status;
+    frame.data[1] = blockSize;
+    frame.data[2] = separationTimeMin;
+
+    // Mailboxes full: retry from update() before the BMS gives up (N_Bs)
+    flowControlPending = !bus.tryToSend(frame);
+    pendingStatus = status;
+    return !flowControlPending;
+}
+
+void BDRCANIsoTp::deliver(const uint8_t* payload, uint16_t length) {
+    // Negative response: 0x7F, requested mode, reason code
+    if (length >= 1 && payload[0] == 0x7F) {
+        stats.negative++;
+        return;
+    }
+
+    // Positive mode 0x22 response: 0x62, PID high, PID low, data...
+    if (length < 3 || payload[0] != 0x62) return;
+
+    OBD2Response response;
+    response.pid = (payload[1] << 8) | payload[2];
+    response.definition = BDRCANLib::findMessageByID(response.pid);
+    response.data = &payload[3];
+    response.length = length - 3;
+    response.count = 0;
+
+    if (response.definition != nullptr) {
+        response.count = lib.interpretBMSArray(response.data, response.length, *response.definition,
+                                               response.values, sizeof(response.values) / sizeof(response.values[0]));
+    }
+
+    stats.completed++;
+    if (handler != nullptr) {
+        handler(response, handlerContext);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+    bdrcanisotp.h - ISO-TP (ISO 15765-2) receiver for Orion BMS OBD2 responses.
+
+    Mode 0x22 answers longer than 7 bytes, such as the 12-cell voltage arrays, arrive as a
+    first frame plus consecutive frames. The receiver reassembles them into a preallocated
+    buffer (no heap), sends the flow control frames, and hands the payload straight to the
+    BMS decoders.
+    */
+
+    #ifndef bdrcanisotp_h
+    #define bdrcanisotp_h
+    #include "Arduino.h"
+    #include <ACAN_T4.h>
+    #include "bdrcanlib.h"
+
+    struct OBD2Response {
+        uint16_t pid;                   // PID echoed by the BMS
+        const CanMessage* definition;   // nullptr if the PID is not in the table
+        const uint8_t* data;            // payload after the 0x62 / PID header
+        uint8_t length;                 // payload length in bytes
+        float values[12];               // decoded values, one per element (12 for cell arrays)
+        uint8_t count;                  // number of decoded values
+    };
+
+    struct IsoTpStats {
+        uint32_t completed;             // responses reassembled and delivered
+        uint32_t negative;              // 0x7F negative responses from the BMS
+        uint32_t sequenceErrors;        // consecutive frame out of order, transfer dropped
+        uint32_t timeouts;              // consecutive frame not received in time, transfer dropped
+        uint32_t overflows;             // response larger than the reassembly buffer
+        uint32_t flowControlRetries;    // flow control frames that had to be re-sent
+    };
+
+    class BDRCANIsoTp {
+    public:
+        typedef void (*ResponseHandler)(const OBD2Response& response, void* context);
+
+        BDRCANIsoTp(ACAN_T4& bus = ACAN_T4::can2);
+
+        // Called once per complete response
+        void onResponse(ResponseHandler handler, void* context = nullptr);
+
+        // Flow control parameters sent to the BMS. The defaults (block size 0, STmin 0) let it
+        // stream the whole response back-to-back without waiting for further flow control.
+        void setFlowControl(uint8_t blockSize, uint8_t separationTimeMin);
+
+        // Feed every received frame; returns true if the frame was part of a response
+        bool handleFrame(const CANMessage& frame);
+
+        // Retry pending flow control and drop stalled transfers; call from loop()
+        void update();
+
+        const IsoTpStats& getStats() const { return stats; }
+
+        static const uint32_t RESPONSE_ID = 0x7EB;      // Orion BMS OBD2 response ID
+        static const uint32_t FLOW_CONTROL_ID = 0x7E3;  // Orion BMS physical request ID
+        static const int MAX_PAYLOAD = 64;              // largest response kept (cell arrays use 27)
+        static const uint32_t TIMEOUT_MS = 1000;        // N_Cr: max gap between consecutive frames
+
+    private:
+        enum FlowStatus {
+            FLOW_CONTINUE = 0x30,
+            FLOW_OVERFLOW = 0x32
+        };
+
+        bool sendFlowControl(uint8_t status);
+        void deliver(const uint8_t* payload, uint16_t length);
+
+        BDRCANLib lib;
+        ACAN_T4& bus;
+        ResponseHandler handler = nullptr;
+        void* handlerContext = nullptr;
+        IsoTpStats stats;
+
+        uint8_t blockSize = 0;
+        uint8_t separationTimeMin = 0;
+
+        // Reassembly state. ISO-TP is half-duplex per responder, so one buffer serves
+        // every request sent to the BMS.
+        uint8_t buffer[MAX_PAYLOAD];
+        uint16_t expected = 0;
+        uint16_t received = 0;
+        uint8_t nextSequence = 0;
+        uint8_t blockRemaining = 0;
+        bool active = false;
+        bool flowControlPending = false;
+        uint8_t pendingStatus = FLOW_CONTINUE;
+        uint32_t lastFrameMs = 0;
+    };
+
+#endif
@@ -1,5 +1,7 @@
 #include "Arduino.h"
 #include "bdrcanlib.h"
+#include "bdrcansignal.h"
+#include "bdrcantxqueue.h"
 
 BDRCANLib::BDRCANLib() {
     // constructor body left intentionally empty — real init can go in begin()
@@ -38,7 +40,9 @@ void BDRCANLib::sendOBD2Request(uint16_t pid)
     frame.data[6] = 0x00;
     frame.data[7] = 0x00;
 
-    const bool ok = ACAN_T4::can2.tryToSend(frame);
+    // A queue retries on full mailboxes and keeps polls behind the inverter commands
+    const bool ok = (txQueue != nullptr) ? txQueue->send(frame, TX_POLLING)
+                                         : ACAN_T4::can2.tryToSend(frame);
     if (!ok)
     {
         Serial.println("Failed to send OBD2 request");
@@ -47,6 +51,11 @@ void BDRCANLib::sendOBD2Request(uint16_t pid)
     waitingForResponse = true;
 }
 
+void BDRCANLib::setTxQueue(BDRCANTxQueue* queue)
+{
+    txQueue = queue;
+}
+
 
 float BDRCANLib::conv_to_dec(const String& s) {
     String tmp = s;
@@ -56,6 +65,7 @@ float BDRCANLib::conv_to_dec(const String& s) {
 
 uint32_t* BDRCANLib::getAllCANIDs(int* count) {
     static uint32_t ids[] = {
+#if BDRCAN_INVERTER_COMMANDS
         Set_AC_Current.id,
         Set_Brake_Current.id,
         Set_ERPM.id,
@@ -71,6 +81,48 @@ uint32_t* BDRCANLib::getAllCANIDs(int* count) {
         Max_DC_Current.id,
         Set_Maximum_DC_Brake_Current.id,
         Drive_Enable.id,
+#endif
+#if BDRCAN_INVERTER_FEEDBACK
+        // Inverter feedback IDs
+        erpm.id,
+        duty_cycle.id,
+        input_voltage.id,
+        AC_current.id,
+        DC_current.id,
+        RESERVED_1.id,
+        controller_temperature.id,
+        motor_temperature.id,
+        fault_code.id,
+        RESERVED_2.id,
+        Id.id,
+        Iq.id,
+        throttle_signal.id,
+        brake_signal.id,
+        digital_input_1.id,
+        digital_input_2.id,
+        digital_input_3.id,
+        digital_input_4.id,
+        digital_input_1_2.id,
+        digital_input_2_2.id,
+        digital_input_3_2.id,
+        digital_input_4_2.id,
+        drive_enable.id,
+        capacitor_temp_limit.id,
+        DC_current_limit.id,
+        drive_enable_limit.id,
+        igbt_acceleration_temperature_limit.id,
+        igbt_temperature_limit.id,
+        input_voltage_limit.id,
+        motor_acceleration_temperature_limit.id,
+        motor_temperature_limit.id,
+        RPM_min_limit.id,
+        RPM_max_limit.id,
+        power_limit.id,
+        reserved_3.id,
+        reserved_4.id,
+        CAN_map_version.id,
+#endif
+#if BDRCAN_BMS_STATUS
         // Orion BMS CAN IDs
         relays_status.id,
         max_cells_supported_count.id,
@@ -111,6 +163,8 @@ uint32_t* BDRCANLib::getAllCANIDs(int* count) {
         avg_cell_resistance.id,
         input_power_supply_voltage.id,
         fan_voltage.id,
+#endif
+#if BDRCAN_BMS_CELLS
         // Cell voltage arrays
         cell_voltages_1_12.id,
         cell_voltages_13_24.id,
@@ -159,6 +213,7 @@ uint32_t* BDRCANLib::getAllCANIDs(int* count) {
         internal_resistances_145_156.id,
         internal_resistances_157_168.id,
         internal_resistances_169_180.id
+#endif
     };
     
     if (count != nullptr) {
@@ -168,58 +223,123 @@ uint32_t* BDRCANLib::getAllCANIDs(int* count) {
     return ids;
 }
 
-// Interpret inverter message - extract value from raw CAN data
-float BDRCANLib::interpretInverterMessage(const messageStruct& msg, const CanMessage& definition) {
-    // Verify the message ID matches
-    if (msg.id != definition.id) {
-        Serial.println("Error: Message ID mismatch!");
-        return 0.0f;
-    }
-    
-    // Extract the raw value based on bit_start and length
-    int byteIndex = definition.bit_start / 8;
-    int bitOffset = definition.bit_start % 8;
+// Bytes of payload a definition reaches into; the DLC must be at least this
+static constexpr bool isBMSID(uint32_t id) {
+    return id >= 0xF000;
+}
+
+static constexpr int fieldBytes(const CanMessage& definition) {
+    return isBMSID(definition.id) ? (definition.bit_start + definition.length) / 8
+                                  : (definition.bit_start + definition.length + 7) / 8;
+}
+
+// Scale and clamp a raw field; fields with a negative minimum are signed
+static inline float scaleField(uint32_t rawValue, const CanMessage& definition, bool bms) {
     int lengthBits = definition.length;
-    
-    // Check bounds
-    if (byteIndex >= msg.length || (byteIndex + (lengthBits + bitOffset + 7) / 8) > msg.length) {
-        Serial.println("Error: Message data out of bounds!");
-        return 0.0f;
-    }
-    
-    // Extract value (little-endian)
-    int32_t rawValue = 0;
-    int bytesNeeded = (lengthBits + bitOffset + 7) / 8;
-    
-    for (int i = 0; i < bytesNeeded && (byteIndex + i) < 8; i++) {
-        rawValue |= (uint32_t)msg.data[byteIndex + i] << (i * 8);
-    }
-    
-    // Shift to align
-    rawValue >>= bitOffset;
-    
-    // Mask to length
+    bool isSigned = definition.min < 0;
+
     if (lengthBits < 32) {
         uint32_t mask = (1UL << lengthBits) - 1;
         rawValue &= mask;
-        
-        // Handle signed values (check if sign bit is set)
-        if (lengthBits > 1 && (rawValue & (1UL << (lengthBits - 1)))) {
-            // Sign extend
+
+        // Sign extend
+        if (isSigned && (rawValue & (1UL << (lengthBits - 1)))) {
             rawValue |= ~mask;
         }
     }
-    
-    // Apply scaling
-    float scaledValue = (float)rawValue / definition.scale;
-    
+
+    float value = isSigned ? (float)(int32_t)rawValue : (float)rawValue;
+
+    // Apply scaling (inverter tables divide, BMS tables multiply)
+    float scaledValue = bms ? value * definition.scale : value / definition.scale;
+
     // Clamp to min/max
     if (scaledValue < definition.min) scaledValue = definition.min;
     if (scaledValue > definition.max) scaledValue = definition.max;
-    
+
     return scaledValue;
 }
 
+// Field decoders. Bit ranges are validated against the 64-bit payload when the table is
+// compiled (see the static_asserts below), so the only runtime check left is the DLC.
+static inline uint32_t inverterFieldBits(const uint8_t* data, const CanMessage& definition) {
+    int byteIndex = definition.bit_start / 8;
+    int bitOffset = definition.bit_start % 8;
+    int bytesNeeded = (definition.length + bitOffset + 7) / 8;
+
+    // Extract value (little-endian)
+    uint64_t field = 0;
+    for (int i = 0; i < bytesNeeded; i++) {
+        field |= (uint64_t)data[byteIndex + i] << (i * 8);
+    }
+    return (uint32_t)(field >> bitOffset);
+}
+
+static inline uint32_t bmsFieldBits(const uint8_t* data, const CanMessage& definition) {
+    int byteIndex = definition.bit_start / 8;
+    int lengthBytes = definition.length / 8;
+
+    // Extract value (big-endian for BMS)
+    uint32_t rawValue = 0;
+    for (int i = 0; i < lengthBytes; i++) {
+        rawValue = (rawValue << 8) | data[byteIndex + i];
+    }
+    return rawValue;
+}
+
+static inline float decodeInverterField(const uint8_t* data, const CanMessage& definition) {
+    return scaleField(inverterFieldBits(data, definition), definition, false);
+}
+
+static inline float decodeBMSField(const uint8_t* data, const CanMessage& definition) {
+    return scaleField(bmsFieldBits(data, definition), definition, true);
+}
+
+// Raw field without scaling or clamping; false if the frame does not carry the field
+bool BDRCANLib::extractRaw(const messageStruct& msg, const CanMessage& definition, int64_t* raw) {
+    if (msg.id != definition.id || msg.length < fieldBytes(definition)) return false;
+
+    bool bms = isBMSID(definition.id);
+    uint32_t bits = bms ? bmsFieldBits(msg.data, definition) : inverterFieldBits(msg.data, definition);
+    int lengthBits = definition.length;
+
+    if (lengthBits < 32) {
+        uint32_t mask = (1UL << lengthBits) - 1;
+        bits &= mask;
+        if (definition.min < 0 && (bits & (1UL << (lengthBits - 1)))) {
+            *raw = (int64_t)bits - ((int64_t)1 << lengthBits);
+            return true;
+        }
+    } else if (definition.min < 0) {
+        *raw = (int32_t)bits;
+        return true;
+    }
+    *raw = bits;
+    return true;
+}
+
+// Same arithmetic as the decoders, so scaleRaw(extractRaw(...)) equals the decoded value
+float BDRCANLib::scaleRaw(int64_t raw, const CanMessage& definition) {
+    return scaleField((uint32_t)raw, definition, isBMSID(definition.id));
+}
+
+// Interpret inverter message - extract value from raw CAN data
+float BDRCANLib::interpretInverterMessage(const messageStruct& msg, const CanMessage& definition) {
+    // Verify the message ID matches
+    if (msg.id != definition.id) {
+        Serial.println("Error: Message ID mismatch!");
+        return 0.0f;
+    }
+
+    // Check the DLC covers the field
+    if (msg.length < fieldBytes(definition)) {
+        Serial.println("Error: Message data out of bounds!");
+        return 0.0f;
+    }
+
+    return decodeInverterField(msg.data, definition);
+}
+
 // Interpret BMS message - extract value from raw CAN data
 float BDRCANLib::interpretBMSMessage(const messageStruct& msg, const CanMessage& definition) {
     // Verify the message ID matches
@@ -227,118 +347,95 @@ float BDRCANLib::interpretBMSMessage(const messageStruct& msg, const CanMessage&
         Serial.println("Error: Message ID mismatch!");
         return 0.0f;
     }
-    
-    // For BMS messages, the interpretation is similar but may have different byte ordering
-    // BMS typically uses big-endian (MSB first)
-    int byteIndex = definition.bit_start / 8;
-    int lengthBytes = definition.length / 8;
-    
-    // Check bounds
-    if (byteIndex >= msg.length || (byteIndex + lengthBytes) > msg.length) {
+
+    // Check the DLC covers the field
+    if (msg.length < fieldBytes(definition)) {
         Serial.println("Error: Message data out of bounds!");
         return 0.0f;
     }
-    
-    // Extract value (big-endian for BMS)
-    int32_t rawValue = 0;
-    
-    for (int i = 0; i < lengthBytes && (byteIndex + i) < 8; i++) {
-        rawValue = (rawValue << 8) | msg.data[byteIndex + i];
+
+    return decodeBMSField(msg.data, definition);
+}
+
+// Interpret BMS payload - one element of a reassembled OBD2 response
+float BDRCANLib::interpretBMSPayload(const uint8_t* data, uint8_t length, const CanMessage& definition, int element) {
+    int offset = element * (definition.length / 8);
+
+    // Check the payload covers the element
+    if (data == nullptr || element < 0 || offset + fieldBytes(definition) > length) {
+        Serial.println("Error: Message data out of bounds!");
+        return 0.0f;
     }
-    
-    // Handle signed values (for 16-bit signed)
-    if (lengthBytes == 2 && (rawValue & 0x8000)) {
-        rawValue |= 0xFFFF0000; // Sign extend
-    } else if (lengthBytes == 4 && (rawValue & 0x80000000)) {
-        // Already 32-bit, no extension needed
+
+    return decodeBMSField(data + offset, definition);
+}
+
+// Interpret BMS array - every element that fits in a reassembled OBD2 response
+int BDRCANLib::interpretBMSArray(const uint8_t* data, uint8_t length, const CanMessage& definition, float* values, int maxValues) {
+    if (data == nullptr) return 0;
+
+    int elementBytes = definition.length / 8;
+    int count = (length - definition.bit_start / 8) / elementBytes;
+    if (count < 0) count = 0;
+    if (count > maxValues) count = maxValues;
+
+    for (int i = 0; i < count; i++) {
+        values[i] = decodeBMSField(data + i * elementBytes, definition);
     }
-    
-    // Apply scaling
-    float scaledValue = (float)rawValue * definition.scale;
-    
-    // Clamp to min/max
-    if (scaledValue < definition.min) scaledValue = definition.min;
-    if (scaledValue > definition.max) scaledValue = definition.max;
-    
-    return scaledValue;
+    return count;
 }
 
-// Find message definition by CAN ID
-const CanMessage* BDRCANLib::findMessageByID(uint32_t id) {
-    // Check inverter messages (0x01 - 0x0F range)
-    if (id == Set_AC_Current.id) return &Set_AC_Current;
-    if (id == Set_Brake_Current.id) return &Set_Brake_Current;
-    if (id == Set_ERPM.id) return &Set_ERPM;
-    if (id == Set_Position.id) return &Set_Position;
-    if (id == Set_Relative_Current.id) return &Set_Relative_Current;
-    if (id == Set_Relative_Brake_Current.id) return &Set_Relative_Brake_Current;
-    if (id == Set_Digital_Output_1.id) return &Set_Digital_Output_1;
-    if (id == Max_AC_Current.id) return &Max_AC_Current;
-    if (id == Set_Maximum_AC_Brake_Current.id) return &Set_Maximum_AC_Brake_Current;
-    if (id == Max_DC_Current.id) return &Max_DC_Current;
-    if (id == Set_Maximum_DC_Brake_Current.id) return &Set_Maximum_DC_Brake_Current;
-    if (id == Drive_Enable.id) return &Drive_Enable;
-    
-    // Check BMS messages (0xF000+ range)
-    if (id == relays_status.id) return &relays_status;
-    if (id == max_cells_supported_count.id) return &max_cells_supported_count;
-    if (id == populated_cell_count.id) return &populated_cell_count;
-    if (id == pack_charge_current_limit.id) return &pack_charge_current_limit;
-    if (id == pack_discharge_current_limit.id) return &pack_discharge_current_limit;
-    if (id == signed_pack_current.id) return &signed_pack_current;
-    if (id == unsigned_pack_current.id) return &unsigned_pack_current;
-    if (id == pack_voltage.id) return &pack_voltage;
-    if (id == pack_open_voltage.id) return &pack_open_voltage;
-    if (id == pack_state_of_charge.id) return &pack_state_of_charge;
-    if (id == pack_amphours.id) return &pack_amphours;
-    if (id == pack_resistance.id) return &pack_resistance;
-    if (id == pack_depth_of_discharge.id) return &pack_depth_of_discharge;
-    if (id == pack_health.id) return &pack_health;
-    if (id == pack_summed_voltage.id) return &pack_summed_voltage;
-    if (id == total_pack_cycles.id) return &total_pack_cycles;
-    if (id == highest_pack_temperature.id) return &highest_pack_temperature;
-    if (id == lowest_pack_temperature.id) return &lowest_pack_temperature;
-    if (id == avg_pack_temperature.id) return &avg_pack_temperature;
-    if (id == heatsink_temperature_sensor.id) return &heatsink_temperature_sensor;
-    if (id == fan_speed.id) return &fan_speed;
-    if (id == requested_fan_speed.id) return &requested_fan_speed;
-    if (id == low_cell_voltage.id) return &low_cell_voltage;
-    if (id == low_cell_voltage_id.id) return &low_cell_voltage_id;
-    if (id == high_cell_voltage.id) return &high_cell_voltage;
-    if (id == high_cell_voltage_id.id) return &high_cell_voltage_id;
-    if (id == avg_cell_voltage.id) return &avg_cell_voltage;
-    if (id == low_opencell_voltage.id) return &low_opencell_voltage;
-    if (id == low_opencell_voltage_id.id) return &low_opencell_voltage_id;
-    if (id == high_opencell_voltage.id) return &high_opencell_voltage;
-    if (id == high_opencell_voltage_id.id) return &high_opencell_voltage_id;
-    if (id == avg_opencell_voltage.id) return &avg_opencell_voltage;
-    if (id == low_cell_resistance.id) return &low_cell_resistance;
-    if (id == low_cell_resistance_id.id) return &low_cell_resistance_id;
-    if (id == high_cell_resistance.id) return &high_cell_resistance;
-    if (id == high_cell_resistance_id.id) return &high_cell_resistance_id;
-    if (id == avg_cell_resistance.id) return &avg_cell_resistance;
-    if (id == input_power_supply_voltage.id) return &input_power_supply_voltage;
-    if (id == fan_voltage.id) return &fan_voltage;
-    
-    // Cell voltage arrays
-    if (id == cell_voltages_1_12.id) return &cell_voltages_1_12;
-    if (id == cell_voltages_13_24.id) return &cell_voltages_13_24;
-    if (id == cell_voltages_25_36.id) return &cell_voltages_25_36;
-    if (id == cell_voltages_37_48.id) return &cell_voltages_37_48;
-    if (id == cell_voltages_49_60.id) return &cell_voltages_49_60;
-    if (id == cell_voltages_61_72.id) return &cell_voltages_61_72;
-    if (id == cell_voltages_73_84.id) return &cell_voltages_73_84;
-    if (id == cell_voltages_85_96.id) return &cell_voltages_85_96;
-    if (id == cell_voltages_97_108.id) return &cell_voltages_97_108;
-    if (id == cell_voltages_109_120.id) return &cell_voltages_109_120;
-    if (id == cell_voltages_121_132.id) return &cell_voltages_121_132;
-    if (id == cell_voltages_133_144.id) return &cell_voltages_133_144;
-    if (id == cell_voltages_145_156.id) return &cell_voltages_145_156;
-    if (id == cell_voltages_157_168.id) return &cell_voltages_157_168;
-    if (id == cell_voltages_169_180.id) return &cell_voltages_169_180;
-    
-    // Not found
-    return nullptr;
+// Rounded raw value, kept inside the field: at the edge of a 32-bit field the float limit
+// rounds up (2147483647.0f is 2^31), which would wrap to the opposite sign
+static inline int32_t roundRaw(float scaled, const CanMessage& definition) {
+    bool isSigned = definition.min < 0;
+    int64_t rawMax = ((int64_t)1 << (definition.length - (isSigned ? 1 : 0))) - 1;
+    int64_t rawMin = isSigned ? -rawMax - 1 : 0;
+    if (scaled >= (float)rawMax) return (int32_t)rawMax;
+    if (scaled <= (float)rawMin) return (int32_t)rawMin;
+    return (int32_t)lroundf(scaled);
+}
+
+// Encode inverter value - pack a scaled value into raw CAN data
+void BDRCANLib::encodeInverterValue(float value, const CanMessage& definition, uint8_t* data) {
+    // Clamp to min/max before scaling so the raw value stays in range
+    if (value < definition.min) value = definition.min;
+    if (value > definition.max) value = definition.max;
+
+    int byteIndex = definition.bit_start / 8;
+    int bitOffset = definition.bit_start % 8;
+    int lengthBits = definition.length;
+    int bytesNeeded = (lengthBits + bitOffset + 7) / 8;
+
+    // Apply scaling (interpretInverterMessage divides by scale)
+    int32_t rawValue = roundRaw(value * definition.scale, definition);
+
+    uint64_t mask = (lengthBits < 32) ? ((1ULL << lengthBits) - 1) : 0xFFFFFFFFULL;
+    uint64_t field = ((uint64_t)(uint32_t)rawValue & mask) << bitOffset;
+    mask <<= bitOffset;
+
+    // Merge into the existing bytes (little-endian) so neighbouring signals survive
+    for (int i = 0; i < bytesNeeded; i++) {
+        uint8_t byteMask = (uint8_t)(mask >> (i * 8));
+        data[byteIndex + i] = (data[byteIndex + i] & ~byteMask) | ((uint8_t)(field >> (i * 8)) & byteMask);
+    }
+}
+
+// Encode BMS value - pack a scaled value into raw CAN data (big-endian)
+void BDRCANLib::encodeBMSValue(float value, const CanMessage& definition, uint8_t* data) {
+    if (value < definition.min) value = definition.min;
+    if (value > definition.max) value = definition.max;
+
+    int byteIndex = definition.bit_start / 8;
+    int lengthBytes = definition.length / 8;
+
+    // Apply scaling (interpretBMSMessage multiplies by scale)
+    int32_t rawValue = roundRaw(value / definition.scale, definition);
+
+    for (int i = lengthBytes - 1; i >= 0; i--) {
+        data[byteIndex + i] = rawValue & 0xFF;
+        rawValue >>= 8;
+    }
 }
 
 // Helper to determine if a message is from the inverter
@@ -359,203 +456,204 @@ bool BDRCANLib::isBMSMessage(const CanMessage* msg) {
  * Define every CAN ID used in the system.
  * Add or modify as needed for your application.
  */
-const CanMessage Set_AC_Current = {
+#if BDRCAN_INVERTER_COMMANDS
+constexpr CanMessage Set_AC_Current = {
     "Set AC Current",
     0x01,
     "ac current",
-    "0",
-    1,
-    8,
+    "0-1",
+    0,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "A_pk",
-    "This command sets the target motor AC current (peak, not RMS). When the controller receives this message, it automatically switches to current control mode. This value must not be above the limits of the inverter and must be multiplied by 10 before sending. This is a signed parameter, and the sign represents the direction of the torque which correlates with the motor AC current. (For the correlation, please refer to the motor parameters)"
+    BDRCAN_DESCRIPTION("This command sets the target motor AC current (peak, not RMS). When the controller receives this message, it automatically switches to current control mode. This value must not be above the limits of the inverter and must be multiplied by 10 before sending. This is a signed parameter, and the sign represents the direction of the torque which correlates with the motor AC current. (For the correlation, please refer to the motor parameters)")
 };
 
-const CanMessage Set_Brake_Current = {
+constexpr CanMessage Set_Brake_Current = {
     "Set Brake current",
     0x02,
     "target brake current",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "A_pk",
-    "Targets the brake current of the motor. It will result negative torque relatively to the forward direction of the motor. This value must be multiplied by 10 before sending, only positive currents are accepted."
+    BDRCAN_DESCRIPTION("Targets the brake current of the motor. It will result negative torque relatively to the forward direction of the motor. This value must be multiplied by 10 before sending, only positive currents are accepted.")
 };
 
-const CanMessage Set_ERPM = {
+constexpr CanMessage Set_ERPM = {
     "Set ERPM",
     0x03,
     "Set speed (ERPM)",
     "0-3",
     0,
-    8,
+    32,
     -2147483648.0f,
     2147483647.0f,
     1.0f,
     "ERPM",
-    "This command enables the speed control of the motor with a target ERPM. This is a signed parameter, and the sign represents the direction of the spinning. For better operation you need to tune the PID of speed control. Equation: ERPM = Motor RPM * number of the motor pole pairs."
+    BDRCAN_DESCRIPTION("This command enables the speed control of the motor with a target ERPM. This is a signed parameter, and the sign represents the direction of the spinning. For better operation you need to tune the PID of speed control. Equation: ERPM = Motor RPM * number of the motor pole pairs.")
 };
 
-const CanMessage Set_Position = {
+constexpr CanMessage Set_Position = {
     "Set Position",
     0x04,
     "Target position",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "degree",
-    "This value targets the desired position of the motor in degrees. This command is used to hold a position of the motor. This feature is enabled only if encoder is used as position sensor. The value has to be multiplied by 10 before sending."
+    BDRCAN_DESCRIPTION("This value targets the desired position of the motor in degrees. This command is used to hold a position of the motor. This feature is enabled only if encoder is used as position sensor. The value has to be multiplied by 10 before sending.")
 };
 
-const CanMessage Set_Relative_Current = {
+constexpr CanMessage Set_Relative_Current = {
     "Set Relative current",
     0x05,
     "Set relative current",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "%",
-    "This command sets a relative AC current to the minimum and maximum limits set by configuration. This achieves the same function as the “Set AC current” command. Gives you a freedom to send values between -100,0% and 100,0%. You do not need to know the motor limit parameters. This value must be between -100 and 100 and must be multiplied by 10 before sending."
+    BDRCAN_DESCRIPTION("This command sets a relative AC current to the minimum and maximum limits set by configuration. This achieves the same function as the “Set AC current” command. Gives you a freedom to send values between -100,0% and 100,0%. You do not need to know the motor limit parameters. This value must be between -100 and 100 and must be multiplied by 10 before sending.")
 };
 
-const CanMessage Set_Relative_Brake_Current = {
+constexpr CanMessage Set_Relative_Brake_Current = {
     "Set relative brake current",
     0x06,
     "",
     "0-1",
     0,
-    8,
-    0.0f,
+    16,
     0.0f,
-    1.0f,
-    "",
-    "Targets the relative brake current of the motor. It will result negative torque relatively to the forward direction of the motor. This value must be between 0 and 100 and must be multiplied by 10 before sending Gives you a freedom to send values between 0% and 100,0%. You do not need to know the motor limit parameters. This value must be between 0 and 100 and has to be multiplied by 10 before sending"
+    100.0f,
+    10.0f,
+    "%",
+    BDRCAN_DESCRIPTION("Targets the relative brake current of the motor. It will result negative torque relatively to the forward direction of the motor. This value must be between 0 and 100 and must be multiplied by 10 before sending Gives you a freedom to send values between 0% and 100,0%. You do not need to know the motor limit parameters. This value must be between 0 and 100 and has to be multiplied by 10 before sending")
 };
 
-const CanMessage Set_Digital_Output_1 = {
+constexpr CanMessage Set_Digital_Output_1 = {
     "Set digital output",
     0x07,
     "Sets an output to HIGH or LOW",
     "0",
     0,
-    8,
+    1,
     0.0f,
     1.0f,
     1.0f,
     "#",
-    "Sets the digital output 1 to HIGH (1) or LOW (0) state"
+    BDRCAN_DESCRIPTION("Sets the digital output 1 to HIGH (1) or LOW (0) state")
 };
 
-const CanMessage Set_Digital_Output_2 = {
+constexpr CanMessage Set_Digital_Output_2 = {
     "Set digital output",
     0x07,
     "Sets an output to HIGH or LOW",
     "0",
     1,
-    8,
+    1,
     0.0f,
     1.0f,
     1.0f,
     "#",
-    "Sets the digital output 2 to HIGH (1) or LOW (0) state"
+    BDRCAN_DESCRIPTION("Sets the digital output 2 to HIGH (1) or LOW (0) state")
 };
 
-const CanMessage Set_Digital_Output_3 = {
+constexpr CanMessage Set_Digital_Output_3 = {
     "Set digital output",
     0x07,
     "Sets an output to HIGH or LOW",
     "0",
     2,
-    8,
+    1,
     0.0f,
     1.0f,
     1.0f,
     "#",
-    "Sets the digital output 3 to HIGH (1) or LOW (0) state"
+    BDRCAN_DESCRIPTION("Sets the digital output 3 to HIGH (1) or LOW (0) state")
 };
 
-const CanMessage Set_Digital_Output_4 = {
+constexpr CanMessage Set_Digital_Output_4 = {
     "Set digital output",
     0x07,
     "Sets an output to HIGH or LOW",
     "0",
     3,
-    8,
+    1,
     0.0f,
     1.0f,
     1.0f,
     "#",
-    "Sets the digital output 4 to HIGH (1) or LOW (0) state"
+    BDRCAN_DESCRIPTION("Sets the digital output 4 to HIGH (1) or LOW (0) state")
 };
 
-const CanMessage Max_AC_Current = {
+constexpr CanMessage Max_AC_Current = {
     "Max AC Current",
     0x08,
     "Limiting command",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "A_pk",
-    "This value determines the maximum allowable drive current on the AC side. With this function you are able maximize the maximum torque on the motor. The value must be multiplied by 10 before sending."
+    BDRCAN_DESCRIPTION("This value determines the maximum allowable drive current on the AC side. With this function you are able maximize the maximum torque on the motor. The value must be multiplied by 10 before sending.")
 };
 
-const CanMessage Set_Maximum_AC_Brake_Current = {
+constexpr CanMessage Set_Maximum_AC_Brake_Current = {
     "Set maximum AC brake current",
     0x09,
     "Limiting command",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "A_pk",
-    "This value sets the maximum allowable brake current on the AC side. This value must be multiplied by 10 before sending, only negative currents are accepted."
+    BDRCAN_DESCRIPTION("This value sets the maximum allowable brake current on the AC side. This value must be multiplied by 10 before sending, only negative currents are accepted.")
 };
 
-const CanMessage Max_DC_Current = {
+constexpr CanMessage Max_DC_Current = {
     "Max DC Current",
     0x0A,
     "Limiting command",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "A",
-    "This value determines the maximum allowable drive current on the DC side. With this command the BMS can limit the maximum allowable battery discharge current. The value has to be multiplied by 10 before sending."
+    BDRCAN_DESCRIPTION("This value determines the maximum allowable drive current on the DC side. With this command the BMS can limit the maximum allowable battery discharge current. The value has to be multiplied by 10 before sending.")
 };
 
-const CanMessage Set_Maximum_DC_Brake_Current = {
+constexpr CanMessage Set_Maximum_DC_Brake_Current = {
     "Set maximum DC brake current",
     0x0B,
     "Limiting command",
     "0-1",
     0,
-    8,
+    16,
     -3276.8f,
     3276.7f,
     10.0f,
     "%",
-    "This value determines the maximum allowable brake current on the DC side. With this command the BMS can limit the maximum allowable battery charge current. The value has to be multiplied by 10 before sending. Only negative currents are accepted."
+    BDRCAN_DESCRIPTION("This value determines the maximum allowable brake current on the DC side. With this command the BMS can limit the maximum allowable battery charge current. The value has to be multiplied by 10 before sending. Only negative currents are accepted.")
 };
 
-const CanMessage Drive_Enable = {
+constexpr CanMessage Drive_Enable = {
     "Drive Enable",
     0x0C,
     "Limiting command",
@@ -566,11 +664,14 @@ const CanMessage Drive_Enable = {
     255,
     1,
     "#",
-    "0: Drive not allowed 1: Drive allowed Only 0 and 1 values are accepted. Must be sent periodically to be enabled. Refer to chapter 4.3"
+    BDRCAN_DESCRIPTION("0: Drive not allowed 1: Drive allowed Only 0 and 1 values are accepted. Must be sent periodically to be enabled. Refer to chapter 4.3")
 };
 
+#endif // BDRCAN_INVERTER_COMMANDS
+
+#if BDRCAN_INVERTER_FEEDBACK
 // Inverter Feedback Messages (Status/Telemetry from motor controller)
-const CanMessage erpm = {
+constexpr CanMessage erpm = {
     "ERPM",
     0x20,
     "Motor speed",
@@ -581,10 +682,10 @@ const CanMessage erpm = {
     2147483647.0f,
     1.0f,
     "ERPM",
-    "Current electrical RPM of the motor"
+    BDRCAN_DESCRIPTION("Current electrical RPM of the motor")
 };
 
-const CanMessage duty_cycle = {
+constexpr CanMessage duty_cycle = {
     "Duty Cycle",
     0x21,
     "PWM duty",
@@ -593,12 +694,12 @@ const CanMessage duty_cycle = {
     16,
     0.0f,
     100.0f,
-    0.1f,
+    10.0f,
     "%",
-    "Current duty cycle percentage"
+    BDRCAN_DESCRIPTION("Current duty cycle percentage")
 };
 
-const CanMessage input_voltage = {
+constexpr CanMessage input_voltage = {
     "Input Voltage",
     0x22,
     "DC bus voltage",
@@ -607,12 +708,12 @@ const CanMessage input_voltage = {
     16,
     0.0f,
     655.35f,
-    0.01f,
+    100.0f,
     "V",
-    "DC bus input voltage"
+    BDRCAN_DESCRIPTION("DC bus input voltage")
 };
 
-const CanMessage AC_current = {
+constexpr CanMessage AC_current = {
     "AC Current",
     0x23,
     "Motor current",
@@ -621,12 +722,12 @@ const CanMessage AC_current = {
     16,
     -3276.8f,
     3276.7f,
-    0.1f,
+    10.0f,
     "A_pk",
-    "Current AC motor current"
+    BDRCAN_DESCRIPTION("Current AC motor current")
 };
 
-const CanMessage DC_current = {
+constexpr CanMessage DC_current = {
     "DC Current",
     0x24,
     "Battery current",
@@ -635,12 +736,12 @@ const CanMessage DC_current = {
     16,
     -3276.8f,
     3276.7f,
-    0.1f,
+    10.0f,
     "A",
-    "Current DC battery current"
+    BDRCAN_DESCRIPTION("Current DC battery current")
 };
 
-const CanMessage RESERVED_1 = {
+constexpr CanMessage RESERVED_1 = {
     "Reserved 1",
     0x25,
     "",
@@ -651,10 +752,10 @@ const CanMessage RESERVED_1 = {
     0.0f,
     1.0f,
     "",
-    "Reserved for future use"
+    BDRCAN_DESCRIPTION("Reserved for future use")
 };
 
-const CanMessage controller_temperature = {
+constexpr CanMessage controller_temperature = {
     "Controller Temperature",
     0x26,
     "Inverter temp",
@@ -663,12 +764,12 @@ const CanMessage controller_temperature = {
     16,
     -40.0f,
     215.0f,
-    0.1f,
+    10.0f,
     "°C",
-    "Temperature of the motor controller"
+    BDRCAN_DESCRIPTION("Temperature of the motor controller")
 };
 
-const CanMessage motor_temperature = {
+constexpr CanMessage motor_temperature = {
     "Motor Temperature",
     0x27,
     "Motor temp",
@@ -677,12 +778,12 @@ const CanMessage motor_temperature = {
     16,
     -40.0f,
     215.0f,
-    0.1f,
+    10.0f,
     "°C",
-    "Temperature of the motor"
+    BDRCAN_DESCRIPTION("Temperature of the motor")
 };
 
-const CanMessage fault_code = {
+constexpr CanMessage fault_code = {
     "Fault Code",
     0x28,
     "Error code",
@@ -693,10 +794,10 @@ const CanMessage fault_code = {
     65535.0f,
     1.0f,
     "",
-    "Current fault/error code"
+    BDRCAN_DESCRIPTION("Current fault/error code")
 };
 
-const CanMessage RESERVED_2 = {
+constexpr CanMessage RESERVED_2 = {
     "Reserved 2",
     0x29,
     "",
@@ -707,10 +808,10 @@ const CanMessage RESERVED_2 = {
     0.0f,
     1.0f,
     "",
-    "Reserved for future use"
+    BDRCAN_DESCRIPTION("Reserved for future use")
 };
 
-const CanMessage Id = {
+constexpr CanMessage Id = {
     "Id Current",
     0x2A,
     "D-axis current",
@@ -719,12 +820,12 @@ const CanMessage Id = {
     16,
     -3276.8f,
     3276.7f,
-    0.1f,
+    10.0f,
     "A",
-    "D-axis current component"
+    BDRCAN_DESCRIPTION("D-axis current component")
 };
 
-const CanMessage Iq = {
+constexpr CanMessage Iq = {
     "Iq Current",
     0x2B,
     "Q-axis current",
@@ -733,12 +834,12 @@ const CanMessage Iq = {
     16,
     -3276.8f,
     3276.7f,
-    0.1f,
+    10.0f,
     "A",
-    "Q-axis current component"
+    BDRCAN_DESCRIPTION("Q-axis current component")
 };
 
-const CanMessage throttle_signal = {
+constexpr CanMessage throttle_signal = {
     "Throttle Signal",
     0x2C,
     "Throttle input",
@@ -747,12 +848,12 @@ const CanMessage throttle_signal = {
     16,
     0.0f,
     100.0f,
-    0.1f,
+    10.0f,
     "%",
-    "Throttle input signal percentage"
+    BDRCAN_DESCRIPTION("Throttle input signal percentage")
 };
 
-const CanMessage brake_signal = {
+constexpr CanMessage brake_signal = {
     "Brake Signal",
     0x2D,
     "Brake input",
@@ -761,12 +862,12 @@ const CanMessage brake_signal = {
     16,
     0.0f,
     100.0f,
-    0.1f,
+    10.0f,
     "%",
-    "Brake input signal percentage"
+    BDRCAN_DESCRIPTION("Brake input signal percentage")
 };
 
-const CanMessage digital_input_1 = {
+constexpr CanMessage digital_input_1 = {
     "Digital Input 1",
     0x2E,
     "DI1",
@@ -777,10 +878,10 @@ const CanMessage digital_input_1 = {
     1.0f,
     1.0f,
     "",
-    "State of digital input 1"
+    BDRCAN_DESCRIPTION("State of digital input 1")
 };
 
-const CanMessage digital_input_2 = {
+constexpr CanMessage digital_input_2 = {
     "Digital Input 2",
     0x2E,
     "DI2",
@@ -791,10 +892,10 @@ const CanMessage digital_input_2 = {
     1.0f,
     1.0f,
     "",
-    "State of digital input 2"
+    BDRCAN_DESCRIPTION("State of digital input 2")
 };
 
-const CanMessage digital_input_3 = {
+constexpr CanMessage digital_input_3 = {
     "Digital Input 3",
     0x2E,
     "DI3",
@@ -805,10 +906,10 @@ const CanMessage digital_input_3 = {
     1.0f,
     1.0f,
     "",
-    "State of digital input 3"
+    BDRCAN_DESCRIPTION("State of digital input 3")
 };
 
-const CanMessage digital_input_4 = {
+constexpr CanMessage digital_input_4 = {
     "Digital Input 4",
     0x2E,
     "DI4",
@@ -819,10 +920,10 @@ const CanMessage digital_input_4 = {
     1.0f,
     1.0f,
     "",
-    "State of digital input 4"
+    BDRCAN_DESCRIPTION("State of digital input 4")
 };
 
-const CanMessage digital_input_1_2 = {
+constexpr CanMessage digital_input_1_2 = {
     "Digital Input 1 (Alt)",
     0x2F,
     "DI1_alt",
@@ -833,10 +934,10 @@ const CanMessage digital_input_1_2 = {
     1.0f,
     1.0f,
     "",
-    "Alternate state of digital input 1"
+    BDRCAN_DESCRIPTION("Alternate state of digital input 1")
 };
 
-const CanMessage digital_input_2_2 = {
+constexpr CanMessage digital_input_2_2 = {
     "Digital Input 2 (Alt)",
     0x2F,
     "DI2_alt",
@@ -847,10 +948,10 @@ const CanMessage digital_input_2_2 = {
     1.0f,
     1.0f,
     "",
-    "Alternate state of digital input 2"
+    BDRCAN_DESCRIPTION("Alternate state of digital input 2")
 };
 
-const CanMessage digital_input_3_2 = {
+constexpr CanMessage digital_input_3_2 = {
     "Digital Input 3 (Alt)",
     0x2F,
     "DI3_alt",
@@ -861,10 +962,10 @@ const CanMessage digital_input_3_2 = {
     1.0f,
     1.0f,
     "",
-    "Alternate state of digital input 3"
+    BDRCAN_DESCRIPTION("Alternate state of digital input 3")
 };
 
-const CanMessage digital_input_4_2 = {
+constexpr CanMessage digital_input_4_2 = {
     "Digital Input 4 (Alt)",
     0x2F,
     "DI4_alt",
@@ -875,10 +976,10 @@ const CanMessage digital_input_4_2 = {
     1.0f,
     1.0f,
     "",
-    "Alternate state of digital input 4"
+    BDRCAN_DESCRIPTION("Alternate state of digital input 4")
 };
 
-const CanMessage drive_enable = {
+constexpr CanMessage drive_enable = {
     "Drive Enable Status",
     0x30,
     "Drive status",
@@ -889,10 +990,10 @@ const CanMessage drive_enable = {
     1.0f,
     1.0f,
     "",
-    "Current drive enable status"
+    BDRCAN_DESCRIPTION("Current drive enable status")
 };
 
-const CanMessage capacitor_temp_limit = {
+constexpr CanMessage capacitor_temp_limit = {
     "Capacitor Temp Limit",
     0x31,
     "Cap temp limit active",
@@ -903,10 +1004,10 @@ const CanMessage capacitor_temp_limit = {
     1.0f,
     1.0f,
     "",
-    "Capacitor temperature limit active flag"
+    BDRCAN_DESCRIPTION("Capacitor temperature limit active flag")
 };
 
-const CanMessage DC_current_limit = {
+constexpr CanMessage DC_current_limit = {
     "DC Current Limit",
     0x31,
     "DC limit active",
@@ -917,10 +1018,10 @@ const CanMessage DC_current_limit = {
     1.0f,
     1.0f,
     "",
-    "DC current limit active flag"
+    BDRCAN_DESCRIPTION("DC current limit active flag")
 };
 
-const CanMessage drive_enable_limit = {
+constexpr CanMessage drive_enable_limit = {
     "Drive Enable Limit",
     0x31,
     "Drive enable limit",
@@ -931,10 +1032,10 @@ const CanMessage drive_enable_limit = {
     1.0f,
     1.0f,
     "",
-    "Drive enable limit active flag"
+    BDRCAN_DESCRIPTION("Drive enable limit active flag")
 };
 
-const CanMessage igbt_acceleration_temperature_limit = {
+constexpr CanMessage igbt_acceleration_temperature_limit = {
     "IGBT Accel Temp Limit",
     0x31,
     "IGBT accel limit",
@@ -945,10 +1046,10 @@ const CanMessage igbt_acceleration_temperature_limit = {
     1.0f,
     1.0f,
     "",
-    "IGBT acceleration temperature limit active flag"
+    BDRCAN_DESCRIPTION("IGBT acceleration temperature limit active flag")
 };
 
-const CanMessage igbt_temperature_limit = {
+constexpr CanMessage igbt_temperature_limit = {
     "IGBT Temperature Limit",
     0x31,
     "IGBT temp limit",
@@ -959,10 +1060,10 @@ const CanMessage igbt_temperature_limit = {
     1.0f,
     1.0f,
     "",
-    "IGBT temperature limit active flag"
+    BDRCAN_DESCRIPTION("IGBT temperature limit active flag")
 };
 
-const CanMessage input_voltage_limit = {
+constexpr CanMessage input_voltage_limit = {
     "Input Voltage Limit",
     0x31,
     "Voltage limit",
@@ -973,10 +1074,10 @@ const CanMessage input_voltage_limit = {
     1.0f,
     1.0f,
     "",
-    "Input voltage limit active flag"
+    BDRCAN_DESCRIPTION("Input voltage limit active flag")
 };
 
-const CanMessage motor_acceleration_temperature_limit = {
+constexpr CanMessage motor_acceleration_temperature_limit = {
     "Motor Accel Temp Limit",
     0x31,
     "Motor accel limit",
@@ -987,10 +1088,10 @@ const CanMessage motor_acceleration_temperature_limit = {
     1.0f,
     1.0f,
     "",
-    "Motor acceleration temperature limit active flag"
+    BDRCAN_DESCRIPTION("Motor acceleration temperature limit active flag")
 };
 
-const CanMessage motor_temperature_limit = {
+constexpr CanMessage motor_temperature_limit = {
     "Motor Temperature Limit",
     0x31,
     "Motor temp limit",
@@ -1001,10 +1102,10 @@ const CanMessage motor_temperature_limit = {
     1.0f,
     1.0f,
     "",
-    "Motor temperature limit active flag"
+    BDRCAN_DESCRIPTION("Motor temperature limit active flag")
 };
 
-const CanMessage RPM_min_limit = {
+constexpr CanMessage RPM_min_limit = {
     "RPM Min Limit",
     0x32,
     "Min RPM limit",
@@ -1015,10 +1116,10 @@ const CanMessage RPM_min_limit = {
     1.0f,
     1.0f,
     "",
-    "Minimum RPM limit active flag"
+    BDRCAN_DESCRIPTION("Minimum RPM limit active flag")
 };
 
-const CanMessage RPM_max_limit = {
+constexpr CanMessage RPM_max_limit = {
     "RPM Max Limit",
     0x32,
     "Max RPM limit",
@@ -1029,10 +1130,10 @@ const CanMessage RPM_max_limit = {
     1.0f,
     1.0f,
     "",
-    "Maximum RPM limit active flag"
+    BDRCAN_DESCRIPTION("Maximum RPM limit active flag")
 };
 
-const CanMessage power_limit = {
+constexpr CanMessage power_limit = {
     "Power Limit",
     0x32,
     "Power limit active",
@@ -1043,10 +1144,10 @@ const CanMessage power_limit = {
     1.0f,
     1.0f,
     "",
-    "Power limit active flag"
+    BDRCAN_DESCRIPTION("Power limit active flag")
 };
 
-const CanMessage reserved_3 = {
+constexpr CanMessage reserved_3 = {
     "Reserved 3",
     0x33,
     "",
@@ -1057,10 +1158,10 @@ const CanMessage reserved_3 = {
     0.0f,
     1.0f,
     "",
-    "Reserved for future use"
+    BDRCAN_DESCRIPTION("Reserved for future use")
 };
 
-const CanMessage reserved_4 = {
+constexpr CanMessage reserved_4 = {
     "Reserved 4",
     0x34,
     "",
@@ -1071,10 +1172,10 @@ const CanMessage reserved_4 = {
     0.0f,
     1.0f,
     "",
-    "Reserved for future use"
+    BDRCAN_DESCRIPTION("Reserved for future use")
 };
 
-const CanMessage CAN_map_version = {
+constexpr CanMessage CAN_map_version = {
     "CAN Map Version",
     0x35,
     "Protocol version",
@@ -1085,1185 +1186,1847 @@ const CanMessage CAN_map_version = {
     65535.0f,
     1.0f,
     "",
-    "CAN communication protocol version"
+    BDRCAN_DESCRIPTION("CAN communication protocol version")
 };
 
+#endif // BDRCAN_INVERTER_FEEDBACK
+
+#if BDRCAN_BMS_STATUS
 // Orion BMS CAN messages
-const CanMessage relays_status = {
+constexpr CanMessage relays_status = {
     "Relays Status",
     0xF004,
     "General Broadcast To Network",
     "0",
     0,
-    2,
+    16,
     0.0f,
     65535.0f,
     1.0f,
     "",
-    "General Broadcast To Network: 0x7DF 8 01 3E 00 00 00 00 00 00"
+    BDRCAN_DESCRIPTION("General Broadcast To Network: 0x7DF 8 01 3E 00 00 00 00 00 00")
 };
 
-const CanMessage max_cells_supported_count = {
+constexpr CanMessage max_cells_supported_count = {
     "Max Cells Supported Count",
     0xF006,
     "",
     "0",
     0,
-    1,
+    8,
     0.0f,
     255.0f,
     1.0f,
     "",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage populated_cell_count = {
+constexpr CanMessage populated_cell_count = {
     "Populated Cell Count",
     0xF007,
     "",
     "0",
     0,
-    1,
+    8,
     0.0f,
     255.0f,
     1.0f,
     "",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_charge_current_limit = {
+constexpr CanMessage pack_charge_current_limit = {
     "Pack Charge Current Limit",
     0xF00A,
     "Amps",
     "0",
     0,
-    2,
+    16,
     0.0f,
     65535.0f,
     1.0f,
     "Amps",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_discharge_current_limit = {
+constexpr CanMessage pack_discharge_current_limit = {
     "Pack Discharge Current Limit",
     0xF00B,
     "Amps",
     "0",
     0,
-    2,
+    16,
     0.0f,
     65535.0f,
     1.0f,
     "Amps",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage signed_pack_current = {
+constexpr CanMessage signed_pack_current = {
     "Signed Pack Current",
     0xF00C,
     "Amps",
     "0",
     0,
-    2,
-    -32767.0f,
-    32767.0f,
+    16,
+    -3276.8f,
+    3276.7f,
     0.1f,
     "Amps",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage unsigned_pack_current = {
+constexpr CanMessage unsigned_pack_current = {
     "Unsigned Pack Current",
     0xF015,
     "Amps",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    6553.5f,
     0.1f,
     "Amps",
-    "NOTE: To get actual amperage, subtract 32767 from the value."
+    BDRCAN_DESCRIPTION("NOTE: To get actual amperage, subtract 32767 from the value.")
 };
 
-const CanMessage pack_voltage = {
+constexpr CanMessage pack_voltage = {
     "Pack Voltage",
     0xF00D,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    6553.5f,
     0.1f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_open_voltage = {
+constexpr CanMessage pack_open_voltage = {
     "Pack Open Voltage",
     0xF00E,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    6553.5f,
     0.1f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_state_of_charge = {
+constexpr CanMessage pack_state_of_charge = {
     "Pack State of Charge",
     0xF00F,
     "%",
     "0",
     0,
-    1,
+    8,
     0.0f,
     100.0f,
     0.5f,
     "%",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_amphours = {
+constexpr CanMessage pack_amphours = {
     "Pack Amphours",
     0xF010,
     "Amphours",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    6553.5f,
     0.1f,
     "Amphours",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_resistance = {
+constexpr CanMessage pack_resistance = {
     "Pack Resistance",
     0xF011,
     "mOhm",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    655.35f,
     0.01f,
     "mOhm",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_depth_of_discharge = {
+constexpr CanMessage pack_depth_of_discharge = {
     "Pack Depth of Discharge",
     0xF012,
     "%",
     "0",
     0,
-    1,
+    8,
     0.0f,
     100.0f,
     0.5f,
     "%",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_health = {
+constexpr CanMessage pack_health = {
     "Pack Health",
     0xF013,
     "%",
     "0",
     0,
-    1,
+    8,
     0.0f,
     100.0f,
     1.0f,
     "%",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage pack_summed_voltage = {
+constexpr CanMessage pack_summed_voltage = {
     "Pack Summed Voltage",
     0xF014,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
-    65535.0f,
+    655.35f,
     0.01f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage total_pack_cycles = {
+constexpr CanMessage total_pack_cycles = {
     "Total Pack Cycles",
     0xF018,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     65535.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage highest_pack_temperature = {
+constexpr CanMessage highest_pack_temperature = {
     "Highest Pack Temperature",
     0xF028,
     "Celsius",
     "0",
     0,
-    1,
+    8,
     -40.0f,
     80.0f,
     1.0f,
     "Celsius",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage lowest_pack_temperature = {
+constexpr CanMessage lowest_pack_temperature = {
     "Lowest Pack Temperature",
     0xF029,
     "Celsius",
     "0",
     0,
-    1,
+    8,
     -40.0f,
     80.0f,
     1.0f,
     "Celsius",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage avg_pack_temperature = {
+constexpr CanMessage avg_pack_temperature = {
     "Avg. Pack Temperature",
     0xF02A,
     "Celsius",
     "0",
     0,
-    1,
+    8,
     -40.0f,
     80.0f,
     1.0f,
     "Celsius",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage heatsink_temperature_sensor = {
+constexpr CanMessage heatsink_temperature_sensor = {
     "Heatsink Temperature Sensor",
     0xF02D,
     "Celsius",
     "0",
     0,
-    1,
+    8,
     -40.0f,
     80.0f,
     1.0f,
     "Celsius",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage fan_speed = {
+constexpr CanMessage fan_speed = {
     "Fan Speed",
     0xF02B,
     "#",
     "0",
     0,
-    1,
+    8,
     0.0f,
     6.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage requested_fan_speed = {
+constexpr CanMessage requested_fan_speed = {
     "Requested Fan Speed",
     0xF02C,
     "#",
     "0",
     0,
-    1,
+    8,
     0.0f,
     6.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_cell_voltage = {
+constexpr CanMessage low_cell_voltage = {
     "Low Cell Voltage",
     0xF032,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_cell_voltage_id = {
+constexpr CanMessage low_cell_voltage_id = {
     "Low Cell Voltage ID (Cell Num)",
     0xF03E,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_cell_voltage = {
+constexpr CanMessage high_cell_voltage = {
     "High Cell Voltage",
     0xF033,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_cell_voltage_id = {
+constexpr CanMessage high_cell_voltage_id = {
     "High Cell Voltage ID (Cell Num)",
     0xF03D,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage avg_cell_voltage = {
+constexpr CanMessage avg_cell_voltage = {
     "Avg. Cell Voltage",
     0xF034,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_opencell_voltage = {
+constexpr CanMessage low_opencell_voltage = {
     "Low Opencell Voltage",
     0xF035,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_opencell_voltage_id = {
+constexpr CanMessage low_opencell_voltage_id = {
     "Low Opencell Voltage ID (Cell Num)",
     0xF040,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_opencell_voltage = {
+constexpr CanMessage high_opencell_voltage = {
     "High Opencell Voltage",
     0xF036,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_opencell_voltage_id = {
+constexpr CanMessage high_opencell_voltage_id = {
     "High Opencell Voltage ID (Cell Num)",
     0xF03F,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage avg_opencell_voltage = {
+constexpr CanMessage avg_opencell_voltage = {
     "Avg. Opencell Voltage",
     0xF037,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_cell_resistance = {
+constexpr CanMessage low_cell_resistance = {
     "Low Cell Resistance",
     0xF038,
     "mOhm",
     "0",
     0,
-    2,
+    16,
     0.0f,
     655.35f,
     0.01f,
     "mOhm",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage low_cell_resistance_id = {
+constexpr CanMessage low_cell_resistance_id = {
     "Low Cell Resistance ID (Cell Num)",
     0xF042,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_cell_resistance = {
+constexpr CanMessage high_cell_resistance = {
     "High Cell Resistance",
     0xF039,
     "mOhm",
     "0",
     0,
-    2,
+    16,
     0.0f,
     655.35f,
     0.01f,
     "mOhm",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage high_cell_resistance_id = {
+constexpr CanMessage high_cell_resistance_id = {
     "High Cell Resistance ID (Cell Num)",
     0xF041,
     "#",
     "0",
     0,
-    2,
+    16,
     0.0f,
     180.0f,
     1.0f,
     "#",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage avg_cell_resistance = {
+constexpr CanMessage avg_cell_resistance = {
     "Avg. Cell Resistance",
     0xF03A,
     "mOhm",
     "0",
     0,
-    2,
+    16,
     0.0f,
     655.35f,
     0.01f,
     "mOhm",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage input_power_supply_voltage = {
+constexpr CanMessage input_power_supply_voltage = {
     "Input Power Supply Voltage",
     0xF046,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     35.0f,
     0.1f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
-const CanMessage fan_voltage = {
+constexpr CanMessage fan_voltage = {
     "Fan Voltage",
     0xF049,
     "Volts",
     "0",
     0,
-    2,
+    16,
     0.0f,
     15.0f,
     0.01f,
     "Volts",
-    ""
+    BDRCAN_DESCRIPTION("")
 };
 
+#endif // BDRCAN_BMS_STATUS
+
+#if BDRCAN_BMS_CELLS
 // Cell voltage arrays (15 messages for cells 1-180)
-const CanMessage cell_voltages_1_12 = {
+constexpr CanMessage cell_voltages_1_12 = {
     "Cell Voltages (Cells 1-12)",
     0xF100,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_13_24 = {
+constexpr CanMessage cell_voltages_13_24 = {
     "Cell Voltages (Cells 13-24)",
     0xF101,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_25_36 = {
+constexpr CanMessage cell_voltages_25_36 = {
     "Cell Voltages (Cells 25-36)",
     0xF102,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_37_48 = {
+constexpr CanMessage cell_voltages_37_48 = {
     "Cell Voltages (Cells 37-48)",
     0xF103,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_49_60 = {
+constexpr CanMessage cell_voltages_49_60 = {
     "Cell Voltages (Cells 49-60)",
     0xF104,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_61_72 = {
+constexpr CanMessage cell_voltages_61_72 = {
     "Cell Voltages (Cells 61-72)",
     0xF105,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_73_84 = {
+constexpr CanMessage cell_voltages_73_84 = {
     "Cell Voltages (Cells 73-84)",
     0xF106,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_85_96 = {
+constexpr CanMessage cell_voltages_85_96 = {
     "Cell Voltages (Cells 85-96)",
     0xF107,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_97_108 = {
+constexpr CanMessage cell_voltages_97_108 = {
     "Cell Voltages (Cells 97-108)",
     0xF108,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_109_120 = {
+constexpr CanMessage cell_voltages_109_120 = {
     "Cell Voltages (Cells 109-120)",
     0xF109,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_121_132 = {
+constexpr CanMessage cell_voltages_121_132 = {
     "Cell Voltages (Cells 121-132)",
     0xF10A,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_133_144 = {
+constexpr CanMessage cell_voltages_133_144 = {
     "Cell Voltages (Cells 133-144)",
     0xF10B,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_145_156 = {
+constexpr CanMessage cell_voltages_145_156 = {
     "Cell Voltages (Cells 145-156)",
     0xF10C,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_157_168 = {
+constexpr CanMessage cell_voltages_157_168 = {
     "Cell Voltages (Cells 157-168)",
     0xF10D,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage cell_voltages_169_180 = {
+constexpr CanMessage cell_voltages_169_180 = {
     "Cell Voltages (Cells 169-180)",
     0xF10E,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
 // Opencell voltage arrays (15 messages for cells 1-180)
-const CanMessage opencell_voltages_1_12 = {
+constexpr CanMessage opencell_voltages_1_12 = {
     "Opencell Voltages (Cells 1-12)",
     0xF300,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_13_24 = {
+constexpr CanMessage opencell_voltages_13_24 = {
     "Opencell Voltages (Cells 13-24)",
     0xF301,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_25_36 = {
+constexpr CanMessage opencell_voltages_25_36 = {
     "Opencell Voltages (Cells 25-36)",
     0xF302,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_37_48 = {
+constexpr CanMessage opencell_voltages_37_48 = {
     "Opencell Voltages (Cells 37-48)",
     0xF303,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_49_60 = {
+constexpr CanMessage opencell_voltages_49_60 = {
     "Opencell Voltages (Cells 49-60)",
     0xF304,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_61_72 = {
+constexpr CanMessage opencell_voltages_61_72 = {
     "Opencell Voltages (Cells 61-72)",
     0xF305,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_73_84 = {
+constexpr CanMessage opencell_voltages_73_84 = {
     "Opencell Voltages (Cells 73-84)",
     0xF306,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_85_96 = {
+constexpr CanMessage opencell_voltages_85_96 = {
     "Opencell Voltages (Cells 85-96)",
     0xF307,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_97_108 = {
+constexpr CanMessage opencell_voltages_97_108 = {
     "Opencell Voltages (Cells 97-108)",
     0xF308,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_109_120 = {
+constexpr CanMessage opencell_voltages_109_120 = {
     "Opencell Voltages (Cells 109-120)",
     0xF309,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_121_132 = {
+constexpr CanMessage opencell_voltages_121_132 = {
     "Opencell Voltages (Cells 121-132)",
     0xF30A,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_133_144 = {
+constexpr CanMessage opencell_voltages_133_144 = {
     "Opencell Voltages (Cells 133-144)",
     0xF30B,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_145_156 = {
+constexpr CanMessage opencell_voltages_145_156 = {
     "Opencell Voltages (Cells 145-156)",
     0xF30C,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_157_168 = {
+constexpr CanMessage opencell_voltages_157_168 = {
     "Opencell Voltages (Cells 157-168)",
     0xF30D,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
-const CanMessage opencell_voltages_169_180 = {
+constexpr CanMessage opencell_voltages_169_180 = {
     "Opencell Voltages (Cells 169-180)",
-    0xF23E,
+    0xF30E,
     "Volts",
     "0",
     0,
-    24,
+    16,
     0.0f,
     5.0f,
     0.0001f,
     "Volts",
-    "NOTE: Each message includes 12 voltages (each are 2 bytes long)"
+    BDRCAN_DESCRIPTION("NOTE: Each message includes 12 voltages (each are 2 bytes long)")
 };
 
 // Internal resistance arrays (15 messages for cells 1-180)
-const CanMessage internal_resistances_1_12 = {
+constexpr CanMessage internal_resistances_1_12 = {
     "Internal Resistances (Cells 1-12)",
     0xF200,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_13_24 = {
+constexpr CanMessage internal_resistances_13_24 = {
     "Internal Resistances (Cells 13-24)",
     0xF201,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_25_36 = {
+constexpr CanMessage internal_resistances_25_36 = {
     "Internal Resistances (Cells 25-36)",
     0xF202,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_37_48 = {
+constexpr CanMessage internal_resistances_37_48 = {
     "Internal Resistances (Cells 37-48)",
     0xF203,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_49_60 = {
+constexpr CanMessage internal_resistances_49_60 = {
     "Internal Resistances (Cells 49-60)",
     0xF204,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_61_72 = {
+constexpr CanMessage internal_resistances_61_72 = {
     "Internal Resistances (Cells 61-72)",
     0xF205,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_73_84 = {
+constexpr CanMessage internal_resistances_73_84 = {
     "Internal Resistances (Cells 73-84)",
     0xF206,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_85_96 = {
+constexpr CanMessage internal_resistances_85_96 = {
     "Internal Resistances (Cells 85-96)",
     0xF207,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_97_108 = {
+constexpr CanMessage internal_resistances_97_108 = {
     "Internal Resistances (Cells 97-108)",
     0xF208,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_109_120 = {
+constexpr CanMessage internal_resistances_109_120 = {
     "Internal Resistances (Cells 109-120)",
     0xF209,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_121_132 = {
+constexpr CanMessage internal_resistances_121_132 = {
     "Internal Resistances (Cells 121-132)",
     0xF20A,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_133_144 = {
+constexpr CanMessage internal_resistances_133_144 = {
     "Internal Resistances (Cells 133-144)",
     0xF20B,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_145_156 = {
+constexpr CanMessage internal_resistances_145_156 = {
     "Internal Resistances (Cells 145-156)",
     0xF20C,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_157_168 = {
+constexpr CanMessage internal_resistances_157_168 = {
     "Internal Resistances (Cells 157-168)",
     0xF20D,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
 };
 
-const CanMessage internal_resistances_169_180 = {
+constexpr CanMessage internal_resistances_169_180 = {
     "Internal Resistances (Cells 169-180)",
     0xF20E,
     "mOhms",
     "0",
     0,
-    24,
+    16,
     0.0f,
     327.67f,
     0.01f,
     "mOhms",
-    "NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing)."
-};
\ No newline at end of file
+    BDRCAN_DESCRIPTION("NOTE: Bit 16 (the MSB) indicates whether the cell is actively balancing (1 = balancing, 0 = not balancing).")
+};
+
+#endif // BDRCAN_BMS_CELLS
+
+// Every message definition, in declaration order
+static constexpr const CanMessage* allMessages[] = {
+#if BDRCAN_INVERTER_COMMANDS
+    &Set_AC_Current,
+    &Set_Brake_Current,
+    &Set_ERPM,
+    &Set_Position,
+    &Set_Relative_Current,
+    &Set_Relative_Brake_Current,
+    &Set_Digital_Output_1,
+    &Set_Digital_Output_2,
+    &Set_Digital_Output_3,
+    &Set_Digital_Output_4,
+    &Max_AC_Current,
+    &Set_Maximum_AC_Brake_Current,
+    &Max_DC_Current,
+    &Set_Maximum_DC_Brake_Current,
+    &Drive_Enable,
+#endif
+#if BDRCAN_INVERTER_FEEDBACK
+    &erpm,
+    &duty_cycle,
+    &input_voltage,
+    &AC_current,
+    &DC_current,
+    &RESERVED_1,
+    &controller_temperature,
+    &motor_temperature,
+    &fault_code,
+    &RESERVED_2,
+    &Id,
+    &Iq,
+    &throttle_signal,
+    &brake_signal,
+    &digital_input_1,
+    &digital_input_2,
+    &digital_input_3,
+    &digital_input_4,
+    &digital_input_1_2,
+    &digital_input_2_2,
+    &digital_input_3_2,
+    &digital_input_4_2,
+    &drive_enable,
+    &capacitor_temp_limit,
+    &DC_current_limit,
+    &drive_enable_limit,
+    &igbt_acceleration_temperature_limit,
+    &igbt_temperature_limit,
+    &input_voltage_limit,
+    &motor_acceleration_temperature_limit,
+    &motor_temperature_limit,
+    &RPM_min_limit,
+    &RPM_max_limit,
+    &power_limit,
+    &reserved_3,
+    &reserved_4,
+    &CAN_map_version,
+#endif
+#if BDRCAN_BMS_STATUS
+    &relays_status,
+    &max_cells_supported_count,
+    &populated_cell_count,
+    &pack_charge_current_limit,
+    &pack_discharge_current_limit,
+    &signed_pack_current,
+    &unsigned_pack_current,
+    &pack_voltage,
+    &pack_open_voltage,
+    &pack_state_of_charge,
+    &pack_amphours,
+    &pack_resistance,
+    &pack_depth_of_discharge,
+    &pack_health,
+    &pack_summed_voltage,
+    &total_pack_cycles,
+    &highest_pack_temperature,
+    &lowest_pack_temperature,
+    &avg_pack_temperature,
+    &heatsink_temperature_sensor,
+    &fan_speed,
+    &requested_fan_speed,
+    &low_cell_voltage,
+    &low_cell_voltage_id,
+    &high_cell_voltage,
+    &high_cell_voltage_id,
+    &avg_cell_voltage,
+    &low_opencell_voltage,
+    &low_opencell_voltage_id,
+    &high_opencell_voltage,
+    &high_opencell_voltage_id,
+    &avg_opencell_voltage,
+    &low_cell_resistance,
+    &low_cell_resistance_id,
+    &high_cell_resistance,
+    &high_cell_resistance_id,
+    &avg_cell_resistance,
+    &input_power_supply_voltage,
+    &fan_voltage,
+#endif
+#if BDRCAN_BMS_CELLS
+    &cell_voltages_1_12,
+    &cell_voltages_13_24,
+    &cell_voltages_25_36,
+    &cell_voltages_37_48,
+    &cell_voltages_49_60,
+    &cell_voltages_61_72,
+    &cell_voltages_73_84,
+    &cell_voltages_85_96,
+    &cell_voltages_97_108,
+    &cell_voltages_109_120,
+    &cell_voltages_121_132,
+    &cell_voltages_133_144,
+    &cell_voltages_145_156,
+    &cell_voltages_157_168,
+    &cell_voltages_169_180,
+    &opencell_voltages_1_12,
+    &opencell_voltages_13_24,
+    &opencell_voltages_25_36,
+    &opencell_voltages_37_48,
+    &opencell_voltages_49_60,
+    &opencell_voltages_61_72,
+    &opencell_voltages_73_84,
+    &opencell_voltages_85_96,
+    &opencell_voltages_97_108,
+    &opencell_voltages_109_120,
+    &opencell_voltages_121_132,
+    &opencell_voltages_133_144,
+    &opencell_voltages_145_156,
+    &opencell_voltages_157_168,
+    &opencell_voltages_169_180,
+    &internal_resistances_1_12,
+    &internal_resistances_13_24,
+    &internal_resistances_25_36,
+    &internal_resistances_37_48,
+    &internal_resistances_49_60,
+    &internal_resistances_61_72,
+    &internal_resistances_73_84,
+    &internal_resistances_85_96,
+    &internal_resistances_97_108,
+    &internal_resistances_109_120,
+    &internal_resistances_121_132,
+    &internal_resistances_133_144,
+    &internal_resistances_145_156,
+    &internal_resistances_157_168,
+    &internal_resistances_169_180,
+#endif
+};
+
+// Dense key for every ID page the table uses: inverter IDs 0x00-0x3F, BMS PIDs 0xF000-0xF04F
+// and the three 12-cell array pages 0xF100 / 0xF200 / 0xF300
+static const int ID_KEY_COUNT = 0xC0;
+static const uint8_t NO_SLOT = 0xFF;
+
+static constexpr int idKey(uint32_t id) {
+    return (id < 0x40) ? (int)id
+         : ((id & ~0xFFUL) == 0xF000 && (id & 0xFF) < 0x50) ? (int)(0x40 + (id & 0xFF))
+         : ((id & ~0xFFUL) == 0xF100 && (id & 0xFF) < 0x10) ? (int)(0x90 + (id & 0xFF))
+         : ((id & ~0xFFUL) == 0xF200 && (id & 0xFF) < 0x10) ? (int)(0xA0 + (id & 0xFF))
+         : ((id & ~0xFFUL) == 0xF300 && (id & 0xFF) < 0x10) ? (int)(0xB0 + (id & 0xFF))
+         : -1;
+}
+
+// ID -> slot -> definitions, computed from the message table at compile time
+struct IdIndex {
+    uint8_t keySlot[ID_KEY_COUNT + 1];             // + NO_SLOT for IDs without a key
+    uint8_t slotFirst[BDRCANLib::ID_SLOT_COUNT];
+    uint8_t slotCount[BDRCANLib::ID_SLOT_COUNT];
+    uint8_t slotBytes[BDRCANLib::ID_SLOT_COUNT];   // DLC needed by every signal of the slot
+    int slots;
+
+    constexpr IdIndex() : keySlot(), slotFirst(), slotCount(), slotBytes(), slots(0) {
+        for (int key = 0; key <= ID_KEY_COUNT; key++) {
+            keySlot[key] = NO_SLOT;
+        }
+        for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+            int key = idKey(allMessages[i]->id);
+            if (key < 0) continue;
+            int slot = keySlot[key];
+            if (slot == NO_SLOT) {
+                if (slots >= BDRCANLib::ID_SLOT_COUNT) continue;
+                slot = slots++;
+                keySlot[key] = slot;
+                slotFirst[slot] = i;
+            }
+            slotCount[slot]++;
+            if (fieldBytes(*allMessages[i]) > slotBytes[slot]) {
+                slotBytes[slot] = fieldBytes(*allMessages[i]);
+            }
+        }
+    }
+};
+
+static constexpr IdIndex ID_INDEX{};
+
+/*
+ * Build-time validation of the message table. Each check returns the index of the first
+ * offending entry in allMessages (or -1), so a failing static_assert points at one entry.
+ */
+
+// Field fits the 64-bit payload and the 32-bit decoders; BMS fields are whole bytes
+static constexpr bool validBitRange(const CanMessage& m) {
+    return m.bit_start >= 0 && m.length >= 1 && m.length <= 32 && m.bit_start + m.length <= 64 &&
+           (!isBMSID(m.id) || (m.bit_start % 8 == 0 && m.length % 8 == 0));
+}
+
+static constexpr bool overlaps(const CanMessage& a, const CanMessage& b) {
+    return a.id == b.id && a.bit_start < b.bit_start + b.length && b.bit_start < a.bit_start + a.length;
+}
+
+// Raw range of the field, after scaling, as the decoders would produce it
+static constexpr float representableMin(const CanMessage& m) {
+    return (m.min < 0) ? (isBMSID(m.id) ? -(float)(1ULL << (m.length - 1)) * m.scale
+                                         : -(float)(1ULL << (m.length - 1)) / m.scale)
+                       : 0.0f;
+}
+
+static constexpr float representableMax(const CanMessage& m) {
+    return isBMSID(m.id) ? (float)((1ULL << (m.length - (m.min < 0 ? 1 : 0))) - 1) * m.scale
+                         : (float)((1ULL << (m.length - (m.min < 0 ? 1 : 0))) - 1) / m.scale;
+}
+
+// One raw step in physical units
+static constexpr float scaleStep(const CanMessage& m) {
+    return isBMSID(m.id) ? m.scale : 1.0f / m.scale;
+}
+
+// Limit in raw steps; a limit on the step grid comes out within float error of an integer
+static constexpr double rawSteps(const CanMessage& m, float limit) {
+    return isBMSID(m.id) ? (double)limit / m.scale : (double)limit * m.scale;
+}
+
+static constexpr bool nearInteger(double x) {
+    return x - (double)(int64_t)(x + (x < 0 ? -0.5 : 0.5)) < 0.01 &&
+           x - (double)(int64_t)(x + (x < 0 ? -0.5 : 0.5)) > -0.01;
+}
+
+// Positive scale, ordered limits, and a min/max window inside what the field can represent.
+// An inverted scale (0.1 where the protocol means 10) still fits that window, so the limits
+// must also sit on the raw step grid, and a scaled quantity must span at least half the
+// field's bits of steps: 0..100 % at 0.1 % is 1001 steps of a 16-bit field, not 11.
+static constexpr bool consistentScale(const CanMessage& m) {
+    return m.scale > 0 && m.min <= m.max &&
+           m.min >= representableMin(m) - scaleStep(m) / 2 &&
+           m.max <= representableMax(m) + scaleStep(m) / 2 &&
+           nearInteger(rawSteps(m, m.min)) && nearInteger(rawSteps(m, m.max)) &&
+           (m.scale == 1.0f || rawSteps(m, m.max) - rawSteps(m, m.min) + 1 >= (double)(1ULL << (m.length / 2)));
+}
+
+static constexpr int firstBadBitRange() {
+    for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (!validBitRange(*allMessages[i])) return i;
+    }
+    return -1;
+}
+
+static constexpr int firstOverlap() {
+    for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        for (int j = i + 1; j < BDRCANLib::MESSAGE_COUNT; j++) {
+            if (overlaps(*allMessages[i], *allMessages[j])) return j;
+        }
+    }
+    return -1;
+}
+
+static constexpr int firstBadScale() {
+    for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (validBitRange(*allMessages[i]) && !consistentScale(*allMessages[i])) return i;
+    }
+    return -1;
+}
+
+// An ID that reappears after other IDs would split its slot
+static constexpr int firstSplitID() {
+    for (int i = 1; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (allMessages[i]->id == allMessages[i - 1]->id) continue;
+        for (int j = 0; j < i; j++) {
+            if (allMessages[j]->id == allMessages[i]->id) return i;
+        }
+    }
+    return -1;
+}
+
+// Fields of one ID in bit order, so the fields a short frame still carries come first
+static constexpr int firstUnorderedField() {
+    for (int i = 1; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (allMessages[i]->id == allMessages[i - 1]->id && allMessages[i]->bit_start < allMessages[i - 1]->bit_start) return i;
+    }
+    return -1;
+}
+
+static constexpr int firstUnindexedID() {
+    for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (idKey(allMessages[i]->id) < 0) return i;
+    }
+    return -1;
+}
+
+static constexpr int maxSlotSignals() {
+    int most = 0;
+    for (int slot = 0; slot < ID_INDEX.slots; slot++) {
+        if (ID_INDEX.slotCount[slot] > most) most = ID_INDEX.slotCount[slot];
+    }
+    return most;
+}
+
+static constexpr int distinctIDs() {
+    int count = 0;
+    for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+        if (i == 0 || allMessages[i]->id != allMessages[i - 1]->id) count++;
+    }
+    return count;
+}
+
+static_assert(sizeof(allMessages) / sizeof(allMessages[0]) == BDRCANLib::MESSAGE_COUNT,
+              "MESSAGE_COUNT does not match the message table");
+static_assert(firstBadBitRange() < 0, "CanMessage field outside the 64-bit payload, wider than 32 bits, or a BMS field not byte aligned");
+static_assert(firstOverlap() < 0, "Two CanMessage fields on the same ID overlap");
+static_assert(firstBadScale() < 0, "CanMessage min/max off the raw step grid, outside the field, or spanning too few steps for its scale");
+static_assert(firstSplitID() < 0, "Signals sharing an ID must be declared next to each other");
+static_assert(firstUnorderedField() < 0, "Signals sharing an ID must be declared in bit order");
+static_assert(firstUnindexedID() < 0, "CanMessage ID outside the pages covered by idKey()");
+static_assert(distinctIDs() == BDRCANLib::ID_SLOT_COUNT && ID_INDEX.slots == BDRCANLib::ID_SLOT_COUNT,
+              "ID_SLOT_COUNT does not match the number of distinct IDs");
+static_assert(maxSlotSignals() <= BDRCANLib::MAX_SIGNALS_PER_ID, "MAX_SIGNALS_PER_ID is too small");
+
+// Typed accessor layouts (bdrcansignal.h) must mirror the table entry for entry
+template <const CanMessage& M>
+static constexpr bool layoutMatches() {
+    return SignalLayout<M>::id == M.id && SignalLayout<M>::bitStart == M.bit_start
+        && SignalLayout<M>::length == M.length && SignalLayout<M>::minValue == M.min
+        && SignalLayout<M>::maxValue == M.max && SignalLayout<M>::scale == M.scale;
+}
+
+#define BDRCAN_CHECK_LAYOUT(signal, ...) \
+    static_assert(layoutMatches<signal>(), #signal ": layout in bdrcansignal.h does not match the table");
+#define BDRCAN_COUNT_LAYOUT(signal, ...) + 1
+
+#if BDRCAN_INVERTER_COMMANDS
+BDRCAN_INVERTER_COMMAND_LAYOUTS(BDRCAN_CHECK_LAYOUT)
+#endif
+#if BDRCAN_INVERTER_FEEDBACK
+BDRCAN_INVERTER_FEEDBACK_LAYOUTS(BDRCAN_CHECK_LAYOUT)
+#endif
+#if BDRCAN_BMS_STATUS
+BDRCAN_BMS_STATUS_LAYOUTS(BDRCAN_CHECK_LAYOUT)
+#endif
+#if BDRCAN_BMS_CELLS
+BDRCAN_BMS_CELL_LAYOUTS(BDRCAN_CHECK_LAYOUT)
+#endif
+
+static constexpr int LAYOUT_COUNT = 0
+#if BDRCAN_INVERTER_COMMANDS
+    BDRCAN_INVERTER_COMMAND_LAYOUTS(BDRCAN_COUNT_LAYOUT)
+#endif
+#if BDRCAN_INVERTER_FEEDBACK
+    BDRCAN_INVERTER_FEEDBACK_LAYOUTS(BDRCAN_COUNT_LAYOUT)
+#endif
+#if BDRCAN_BMS_STATUS
+    BDRCAN_BMS_STATUS_LAYOUTS(BDRCAN_COUNT_LAYOUT)
+#endif
+#if BDRCAN_BMS_CELLS
+    BDRCAN_BMS_CELL_LAYOUTS(BDRCAN_COUNT_LAYOUT)
+#endif
+    ;
+static_assert(LAYOUT_COUNT == BDRCANLib::MESSAGE_COUNT, "bdrcansignal.h is missing table entries");
+
+// Find message definition by CAN ID
+const CanMessage* BDRCANLib::findMessageByID(uint32_t id) {
+    int slot = findSlotByID(id);
+    if (slot < 0) return nullptr;
+    return allMessages[ID_INDEX.slotFirst[slot]];
+}
+
+const CanMessage* const* BDRCANLib::getAllMessages(int* count) {
+    if (count != nullptr) {
+        *count = MESSAGE_COUNT;
+    }
+    return allMessages;
+}
+
+/*
+ * Name lookup: a perfect hash of the lowercased names (and alt names), built at compile time.
+ * One FNV-1a pass gives the bucket and two slot hashes; each bucket's displacement d places
+ * its names at (h1 + d * h2) % NAME_SLOTS with no collisions. A lookup is one hash, one slot
+ * read and one compare to reject names that are not in the table.
+ */
+static const int NAME_BUCKETS = 64;
+static const int NAME_SLOTS = 256;                 // power of two: h2 is odd, so d * h2 reaches every slot
+static const uint8_t NO_MESSAGE = 0xFF;
+static_assert(BDRCANLib::MESSAGE_COUNT < NO_MESSAGE, "message index does not fit the name index");
+
+static constexpr char lowerASCII(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static constexpr uint64_t nameHash(const char* s) {
+    uint64_t h = 14695981039346656037ULL;
+    for (; *s != '\0'; s++) {
+        h ^= (uint8_t)lowerASCII(*s);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static constexpr int nameBucket(uint64_t h) {
+    return (int)((h >> 58) % NAME_BUCKETS);
+}
+
+static constexpr int nameSlot(uint64_t h, uint8_t displacement) {
+    return (int)(((uint32_t)h + displacement * ((uint32_t)(h >> 32) | 1)) % NAME_SLOTS);
+}
+
+static constexpr bool sameName(const char* a, const char* b) {
+    for (; *a != '\0' && lowerASCII(*a) == lowerASCII(*b); a++, b++) {}
+    return lowerASCII(*a) == lowerASCII(*b);
+}
+
+static constexpr const char* nameKey(int i, bool alt) {
+    return alt ? allMessages[i]->alt : allMessages[i]->name;
+}
+
+struct NameIndex {
+    uint8_t displacement[NAME_BUCKETS];
+    uint8_t slotMessage[NAME_SLOTS];                // index into allMessages, NO_MESSAGE if empty
+    bool complete;                                  // every name placed
+
+    constexpr NameIndex(bool alt) : displacement(), slotMessage(), complete(true) {
+        uint64_t hashes[BDRCANLib::MESSAGE_COUNT] = {};
+        bool keyed[BDRCANLib::MESSAGE_COUNT] = {};
+        int bucketSize[NAME_BUCKETS] = {};
+        int largest = 0;
+
+        for (int slot = 0; slot < NAME_SLOTS; slot++) {
+            slotMessage[slot] = NO_MESSAGE;
+        }
+        // Empty names are not keys; a repeated name keeps its first entry
+        for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+            keyed[i] = nameKey(i, alt)[0] != '\0';
+            for (int j = 0; j < i && keyed[i]; j++) {
+                if (keyed[j] && sameName(nameKey(j, alt), nameKey(i, alt))) keyed[i] = false;
+            }
+            if (!keyed[i]) continue;
+            hashes[i] = nameHash(nameKey(i, alt));
+            int size = ++bucketSize[nameBucket(hashes[i])];
+            if (size > largest) largest = size;
+        }
+
+        // Largest buckets first, while the table is still empty
+        for (int size = largest; size > 0; size--) {
+            for (int bucket = 0; bucket < NAME_BUCKETS; bucket++) {
+                if (bucketSize[bucket] != size) continue;
+                if (!placeBucket(bucket, hashes, keyed)) complete = false;
+            }
+        }
+    }
+
+    constexpr bool placeBucket(int bucket, const uint64_t* hashes, const bool* keyed) {
+        for (int d = 0; d < 256; d++) {
+            bool fits = true;
+            for (int i = 0; i < BDRCANLib::MESSAGE_COUNT && fits; i++) {
+                if (!keyed[i] || nameBucket(hashes[i]) != bucket) continue;
+                int slot = nameSlot(hashes[i], (uint8_t)d);
+                fits = slotMessage[slot] == NO_MESSAGE;
+                // Two names of the bucket must not land on each other either
+                for (int j = 0; j < i && fits; j++) {
+                    if (keyed[j] && nameBucket(hashes[j]) == bucket && nameSlot(hashes[j], (uint8_t)d) == slot) fits = false;
+                }
+            }
+            if (!fits) continue;
+
+            displacement[bucket] = (uint8_t)d;
+            for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+                if (keyed[i] && nameBucket(hashes[i]) == bucket) slotMessage[nameSlot(hashes[i], (uint8_t)d)] = (uint8_t)i;
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+static constexpr NameIndex NAME_INDEX{false};
+static constexpr NameIndex ALT_INDEX{true};
+static_assert(NAME_INDEX.complete && ALT_INDEX.complete, "no perfect hash for the signal names; change NAME_BUCKETS");
+
+static const CanMessage* findByNameIndex(const NameIndex& index, const char* key, bool alt) {
+    if (key == nullptr || key[0] == '\0') return nullptr;
+    uint64_t h = nameHash(key);
+    uint8_t message = index.slotMessage[nameSlot(h, index.displacement[nameBucket(h)])];
+    if (message == NO_MESSAGE || !sameName(nameKey(message, alt), key)) return nullptr;
+    return allMessages[message];
+}
+
+const CanMessage* BDRCANLib::findMessageByName(const char* name) {
+    return findByNameIndex(NAME_INDEX, name, false);
+}
+
+const CanMessage* BDRCANLib::findMessageByAlt(const char* alt) {
+    return findByNameIndex(ALT_INDEX, alt, true);
+}
+
+// Runtime form of idKey: one table read per ID page instead of a chain of compares, so a mixed
+// bus does not mispredict. Unknown IDs give ID_KEY_COUNT, whose keySlot entry is NO_SLOT.
+struct IdPage {
+    uint8_t base;       // key of the page's first ID
+    uint8_t limit;      // IDs of the page that have keys
+};
+
+static constexpr IdPage ID_PAGES[6] = {
+    { 0x00, 0x40 },     // 0x0000
+    { 0x40, 0x50 },     // 0xF000
+    { 0x90, 0x10 },     // 0xF100
+    { 0xA0, 0x10 },     // 0xF200
+    { 0xB0, 0x10 },     // 0xF300
+    { 0x00, 0x00 }      // anything else
+};
+
+static constexpr int lookupKey(uint32_t id) {
+    uint32_t page = id >> 8;
+    uint32_t index = (page == 0) ? 0 : (page - 0xF0 < 4) ? page - 0xEF : 5;
+    uint32_t low = id & 0xFF;
+    return (low < ID_PAGES[index].limit) ? ID_PAGES[index].base + (int)low : ID_KEY_COUNT;
+}
+
+static constexpr bool lookupKeyMatches() {
+    for (uint32_t id = 0; id < 0x10000; id++) {
+        int key = idKey(id);
+        if (lookupKey(id) != ((key < 0) ? ID_KEY_COUNT : key)) return false;
+    }
+    return lookupKey(0x1F000) == ID_KEY_COUNT && lookupKey(0xFFFFFFFF) == ID_KEY_COUNT;
+}
+
+static_assert(lookupKeyMatches(), "lookupKey() and idKey() disagree");
+
+int BDRCANLib::findSlotByID(uint32_t id) {
+    uint8_t slot = ID_INDEX.keySlot[lookupKey(id)];
+    return (slot == NO_SLOT) ? -1 : slot;
+}
+
+int BDRCANLib::getSlotCount() {
+    return ID_INDEX.slots;
+}
+
+const CanMessage* const* BDRCANLib::getSlotMessages(int slot, int* count) {
+    if (slot < 0 || slot >= ID_INDEX.slots) {
+        if (count != nullptr) *count = 0;
+        return nullptr;
+    }
+    if (count != nullptr) {
+        *count = ID_INDEX.slotCount[slot];
+    }
+    return &allMessages[ID_INDEX.slotFirst[slot]];
+}
+
+int BDRCANLib::findMessageIndex(const CanMessage* msg) {
+    if (msg == nullptr) return -1;
+    int count;
+    const CanMessage* const* defs = getSlotMessages(findSlotByID(msg->id), &count);
+    for (int i = 0; i < count; i++) {
+        if (defs[i] == msg) return (int)(defs - allMessages) + i;
+    }
+    return -1;
+}
+
+// Decode every signal carried by a frame
+int BDRCANLib::decodeFrame(const messageStruct& msg, float* values, int maxValues) {
+    int slot = findSlotByID(msg.id);
+    if (slot < 0) return 0;
+
+    int count = ID_INDEX.slotCount[slot];
+    const CanMessage* const* defs = &allMessages[ID_INDEX.slotFirst[slot]];
+    if (count > maxValues) count = maxValues;
+
+    // Short frame: the slot's fields are in bit order, so the ones inside the DLC come first
+    if (msg.length < ID_INDEX.slotBytes[slot]) {
+        int carried = 0;
+        while (carried < count && fieldBytes(*defs[carried]) <= msg.length) carried++;
+        count = carried;
+    }
+
+    // One DLC check covers every signal decoded here
+    if (isBMSID(msg.id)) {
+        for (int i = 0; i < count; i++) values[i] = decodeBMSField(msg.data, *defs[i]);
+    } else {
+        for (int i = 0; i < count; i++) values[i] = decodeInverterField(msg.data, *defs[i]);
+    }
+    return count;
+}
+
+// Whole 8-byte payload as one word; compilers turn these into a single (byte-swapped) load
+static inline uint64_t loadLittleEndian(const uint8_t* data) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++) word |= (uint64_t)data[i] << (i * 8);
+    return word;
+}
+
+static inline uint64_t loadBigEndian(const uint8_t* data) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++) word = (word << 8) | data[i];
+    return word;
+}
+
+// One field out of the whole payload word. Same arithmetic as scaleField, with the sign
+// extension done without a data-dependent branch.
+static inline float decodeWordField(uint64_t word, const CanMessage& definition, bool bms) {
+    int lengthBits = definition.length;
+    int shift = bms ? 64 - definition.bit_start - lengthBits : definition.bit_start;
+    uint32_t mask = (lengthBits < 32) ? (1UL << lengthBits) - 1 : 0xFFFFFFFFUL;
+    bool isSigned = definition.min < 0;
+    uint32_t signBit = isSigned ? 1UL << (lengthBits - 1) : 0;
+    uint32_t rawValue = (((uint32_t)(word >> shift) & mask) ^ signBit) - signBit;
+
+    float value = isSigned ? (float)(int32_t)rawValue : (float)rawValue;
+    value = bms ? value * definition.scale : value / definition.scale;
+    if (value < definition.min) value = definition.min;
+    if (value > definition.max) value = definition.max;
+    return value;
+}
+
+// Decode a batch into columns. The ID index already resolves each ID to its definitions, so a
+// frame costs one slot lookup and one 8-byte load; every signal is then cut out of that word.
+// Frames are taken in order, so every column stays in frame order.
+int BDRCANLib::decodeBatch(const messageStruct* frames, size_t n, SignalColumn* columns) {
+    if (frames == nullptr || columns == nullptr) return 0;
+    int written = 0;
+
+    for (size_t f = 0; f < n; f++) {
+        const messageStruct& msg = frames[f];
+        int slot = findSlotByID(msg.id);
+        if (slot < 0) continue;
+
+        int first = ID_INDEX.slotFirst[slot];
+        int count = ID_INDEX.slotCount[slot];
+        bool bms = isBMSID(msg.id);
+        bool shortFrame = msg.length < ID_INDEX.slotBytes[slot];
+        uint64_t word = bms ? loadBigEndian(msg.data) : loadLittleEndian(msg.data);
+
+        for (int s = 0; s < count; s++) {
+            const CanMessage& definition = *allMessages[first + s];
+
+            // Short frames end at the first field past the DLC, as in decodeFrame
+            if (shortFrame && fieldBytes(definition) > msg.length) break;
+
+            SignalColumn& column = columns[first + s];
+            if (column.values == nullptr || column.count >= column.capacity) continue;
+
+            column.values[column.count] = decodeWordField(word, definition, bms);
+            if (column.frames != nullptr) column.frames[column.count] = (uint32_t)f;
+            column.count++;
+            written++;
+        }
+    }
+    return written;
+}
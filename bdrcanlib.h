@@ -10,6 +10,7 @@
     #define bdrcanlib_h
     #include "Arduino.h"
     #include <ACAN_T4.h> // required
+    #include "bdrcanconfig.h"
 
     struct CanMessage {
         const char* name;           // main name
@@ -31,6 +32,16 @@
         uint8_t length;
     };
 
+    // One output column of decodeBatch, indexed like getAllMessages()
+    struct SignalColumn {
+        float* values;          // caller-provided, capacity entries; nullptr skips the signal
+        uint32_t* frames;       // optional: index of each value's frame in the batch
+        int capacity;
+        int count;              // values written; decodeBatch appends, set to 0 to start over
+    };
+
+    class BDRCANTxQueue;
+
     class BDRCANLib {
     public:
         BDRCANLib();   // constructor
@@ -44,15 +55,60 @@
         // Send OBD2 request for BMS
         void sendOBD2Request(uint16_t pid);
 
+        // Queue OBD2 requests at TX_POLLING instead of sending them directly (nullptr restores direct sends)
+        void setTxQueue(BDRCANTxQueue* queue);
+
         // Get all CAN IDs
         static uint32_t* getAllCANIDs(int* count = nullptr);
 
         // Interpret messages - extract and scale values from raw CAN data
         float interpretInverterMessage(const messageStruct& msg, const CanMessage& definition);
         float interpretBMSMessage(const messageStruct& msg, const CanMessage& definition);
+
+        // Interpret BMS values from an OBD2 response payload (the bytes after the 0x62 / PID header),
+        // which can be longer than one frame. Arrays decode one value per element.
+        float interpretBMSPayload(const uint8_t* data, uint8_t length, const CanMessage& definition, int element = 0);
+        int interpretBMSArray(const uint8_t* data, uint8_t length, const CanMessage& definition, float* values, int maxValues);
+
+        // Encode a scaled value into raw CAN data (inverse of interpretInverterMessage)
+        static void encodeInverterValue(float value, const CanMessage& definition, uint8_t* data);
+        static void encodeBMSValue(float value, const CanMessage& definition, uint8_t* data);
+        
+        // Raw integer field (sign extended, unscaled, unclamped) and its conversion to the decoded value.
+        // extractRaw returns false if the frame does not carry the field.
+        static bool extractRaw(const messageStruct& msg, const CanMessage& definition, int64_t* raw);
+        static float scaleRaw(int64_t raw, const CanMessage& definition);
         
         // Find message definition by ID
         static const CanMessage* findMessageByID(uint32_t id);
+
+        // Find message definition by name / alt name, ignoring ASCII case; nullptr if unknown.
+        // Constant time (a compile-time perfect hash). Where names repeat, the first entry wins.
+        static const CanMessage* findMessageByName(const char* name);
+        static const CanMessage* findMessageByAlt(const char* alt);
+
+        // Get every message definition, in declaration order
+        static const CanMessage* const* getAllMessages(int* count = nullptr);
+
+        // O(1) ID index: every distinct ID maps to a dense slot number, -1 if unknown
+        static int findSlotByID(uint32_t id);
+        static int getSlotCount();
+
+        // Definitions carried by one slot (signals sharing an ID are declared next to each other)
+        static const CanMessage* const* getSlotMessages(int slot, int* count = nullptr);
+
+        // Position of a definition in getAllMessages(), -1 if not part of the table
+        static int findMessageIndex(const CanMessage* msg);
+
+        // Decode every signal carried by a frame; returns the number of values written.
+        // values[i] belongs to getSlotMessages()[i]; fields past a short frame's DLC are left
+        // out, and since they are the last ones of the slot, the return value is how many it carries.
+        int decodeFrame(const messageStruct& msg, float* values, int maxValues);
+
+        // Decode a batch into per-signal columns (MESSAGE_COUNT entries); returns the number of values written.
+        // Each column receives its values in frame order; a full column drops the rest, and a
+        // short frame adds nothing to the columns of fields past its DLC.
+        int decodeBatch(const messageStruct* frames, size_t n, SignalColumn* columns);
         
         // Helper to determine message type
         static bool isInverterMessage(const CanMessage* msg);
@@ -60,13 +116,21 @@
 
         static const int defmeslen = 8; // Standard CAN message size
         static const uint32_t OBD2_REQUEST_ID = 0x7DF; // Standard OBD2 request ID
+        // Number of CanMessage definitions and of distinct CAN IDs in the enabled groups (bdrcanconfig.h)
+        static const int MESSAGE_COUNT = (BDRCAN_INVERTER_COMMANDS ? 15 : 0) + (BDRCAN_INVERTER_FEEDBACK ? 37 : 0)
+                                       + (BDRCAN_BMS_STATUS ? 39 : 0) + (BDRCAN_BMS_CELLS ? 45 : 0);
+        static const int ID_SLOT_COUNT = (BDRCAN_INVERTER_COMMANDS ? 12 : 0) + (BDRCAN_INVERTER_FEEDBACK ? 22 : 0)
+                                       + (BDRCAN_BMS_STATUS ? 39 : 0) + (BDRCAN_BMS_CELLS ? 45 : 0);
+        static const int MAX_SIGNALS_PER_ID = 8; // Most signals sharing one ID (0x31 limit flags)
         
     private:
         bool waitingForResponse = false;
+        BDRCANTxQueue* txQueue = nullptr;
     };
     
 
 // Global CAN message descriptors (defined in bdrcanlib.cpp)
+#if BDRCAN_INVERTER_COMMANDS
 extern const CanMessage Set_AC_Current;
 extern const CanMessage Set_Brake_Current;
 extern const CanMessage Set_ERPM;
@@ -82,7 +146,9 @@ extern const CanMessage Set_Maximum_AC_Brake_Current;
 extern const CanMessage Max_DC_Current;
 extern const CanMessage Set_Maximum_DC_Brake_Current;
 extern const CanMessage Drive_Enable;
+#endif
 
+#if BDRCAN_INVERTER_FEEDBACK
 // Additional CAN messages
 extern const CanMessage erpm;
 extern const CanMessage duty_cycle;
@@ -121,7 +187,9 @@ extern const CanMessage power_limit;
 extern const CanMessage reserved_3;
 extern const CanMessage reserved_4;
 extern const CanMessage CAN_map_version;
+#endif
 
+#if BDRCAN_BMS_STATUS
 // Orion BMS CAN messages
 extern const CanMessage relays_status;
 extern const CanMessage max_cells_supported_count;
@@ -162,7 +230,9 @@ extern const CanMessage high_cell_resistance_id;
 extern const CanMessage avg_cell_resistance;
 extern const CanMessage input_power_supply_voltage;
 extern const CanMessage fan_voltage;
+#endif
 
+#if BDRCAN_BMS_CELLS
 // Cell voltage arrays (15 messages for cells 1-180)
 extern const CanMessage cell_voltages_1_12;
 extern const CanMessage cell_voltages_13_24;
@@ -213,6 +283,7 @@ extern const CanMessage internal_resistances_133_144;
 extern const CanMessage internal_resistances_145_156;
 extern const CanMessage internal_resistances_157_168;
 extern const CanMessage internal_resistances_169_180;
+#endif
 
     
 
@@ -0,0 +1,172 @@
+#include "Arduino.h"
+#include "bdrcanscheduler.h"
+
+BDRCANScheduler::BDRCANScheduler(ACAN_T4& bus) : bus(bus) {
+    memset(entries, 0, sizeof(entries));
+}
+
+bool BDRCANScheduler::addPeriodic(const CanMessage& definition, uint32_t periodMs, int32_t phaseMs) {
+    if (periodMs == 0) return false;
+
+    Entry* e = findEntry(definition.id);
+    if (e == nullptr) {
+        if (entryCount >= MAX_ENTRIES) return false;
+        e = &entries[entryCount++];
+        memset(e, 0, sizeof(Entry));
+        e->id = definition.id;
+    }
+
+    // Frame length covers every signal registered on this ID
+    int bytesNeeded = (definition.bit_start + definition.length + 7) / 8;
+    if (bytesNeeded > BDRCANLib::defmeslen) bytesNeeded = BDRCANLib::defmeslen;
+    if (bytesNeeded > e->length) e->length = bytesNeeded;
+
+    e->enabled = true;
+    e->periodUs = periodMs * 1000UL;
+    e->autoPhase = (phaseMs == AUTO_PHASE);
+    uint32_t oldPhaseUs = e->phaseUs;
+    e->phaseUs = e->autoPhase ? 0 : ((uint32_t)phaseMs * 1000UL) % e->periodUs;
+    if (started) {
+        e->dueUs += e->phaseUs - oldPhaseUs;
+        if (e->sent == 0 && e->failed == 0) e->dueUs = lastNowUs + e->phaseUs;
+    }
+
+    spreadPhases();
+    return true;
+}
+
+// Spread auto-phased frames evenly across the shortest period so they never burst together
+void BDRCANScheduler::spreadPhases() {
+    uint32_t minPeriodUs = 0;
+    int autoCount = 0;
+    for (int i = 0; i < entryCount; i++) {
+        if (minPeriodUs == 0 || entries[i].periodUs < minPeriodUs) minPeriodUs = entries[i].periodUs;
+        if (entries[i].autoPhase) autoCount++;
+    }
+    if (autoCount == 0) return;
+
+    uint32_t stepUs = minPeriodUs / autoCount;
+    int k = 0;
+    for (int i = 0; i < entryCount; i++) {
+        Entry& e = entries[i];
+        if (!e.autoPhase) continue;
+        uint32_t phaseUs = (k++ * stepUs) % e.periodUs;
+        if (started) e.dueUs += phaseUs - e.phaseUs;
+        e.phaseUs = phaseUs;
+    }
+}
+
+bool BDRCANScheduler::setValue(const CanMessage& definition, float value) {
+    Entry* e = findEntry(definition.id);
+    if (e == nullptr) return false;
+    BDRCANLib::encodeInverterValue(value, definition, e->data);
+    return true;
+}
+
+bool BDRCANScheduler::setData(uint32_t id, const uint8_t* data, uint8_t length) {
+    Entry* e = findEntry(id);
+    if (e == nullptr || data == nullptr || length > BDRCANLib::defmeslen) return false;
+    memcpy(e->data, data, length);
+    e->length = length;
+    return true;
+}
+
+bool BDRCANScheduler::setEnabled(uint32_t id, bool enabled) {
+    Entry* e = findEntry(id);
+    if (e == nullptr) return false;
+    e->enabled = enabled;
+    return true;
+}
+
+void BDRCANScheduler::update() {
+    update(micros());
+}
+
+void BDRCANScheduler::update(uint32_t nowUs) {
+    lastNowUs = nowUs;
+    if (!started) {
+        started = true;
+        for (int i = 0; i < entryCount; i++) {
+            entries[i].dueUs = nowUs + entries[i].phaseUs;
+        }
+    }
+
+    for (int i = 0; i < entryCount; i++) {
+        Entry& e = entries[i];
+        if (!e.enabled) continue;
+
+        // Wrap-safe: micros() rolls over every ~71 minutes
+        int32_t late = (int32_t)(nowUs - e.dueUs);
+        if (late < 0) continue;
+
+        // Mailboxes full: keep the deadline and retry on the next update
+        if (!sendEntry(e, nowUs)) {
+            e.failed++;
+            continue;
+        }
+
+        uint32_t lateUs = (uint32_t)late;
+        if (lateUs >= e.periodUs) {
+            // Ran late by whole periods: count them and realign to the original phase
+            uint32_t skipped = lateUs / e.periodUs;
+            e.missed += skipped;
+            e.dueUs += skipped * e.periodUs;
+            lateUs -= skipped * e.periodUs;
+        }
+        e.dueUs += e.periodUs;
+
+        e.sent++;
+        e.totalJitterUs += lateUs;
+        if (lateUs > e.maxJitterUs) e.maxJitterUs = lateUs;
+    }
+}
+
+bool BDRCANScheduler::sendEntry(Entry& e, uint32_t nowUs) {
+    CANMessage frame;
+    frame.id = e.id;
+    frame.ext = false;
+    frame.len = e.length;
+    memcpy(frame.data, e.data, sizeof(e.data));
+    if (txQueue != nullptr) return txQueue->send(frame, txPriority, nowUs);
+    return bus.tryToSend(frame);
+}
+
+void BDRCANScheduler::setTxQueue(BDRCANTxQueue* queue, TxPriority priority) {
+    txQueue = queue;
+    txPriority = priority;
+}
+
+bool BDRCANScheduler::getStats(uint32_t id, ScheduleStats& stats) const {
+    const Entry* e = findEntry(id);
+    if (e == nullptr) return false;
+    stats.sent = e->sent;
+    stats.failed = e->failed;
+    stats.missed = e->missed;
+    stats.maxJitterUs = e->maxJitterUs;
+    stats.avgJitterUs = e->sent ? (uint32_t)(e->totalJitterUs / e->sent) : 0;
+    return true;
+}
+
+void BDRCANScheduler::resetStats() {
+    for (int i = 0; i < entryCount; i++) {
+        entries[i].sent = 0;
+        entries[i].failed = 0;
+        entries[i].missed = 0;
+        entries[i].maxJitterUs = 0;
+        entries[i].totalJitterUs = 0;
+    }
+}
+
+BDRCANScheduler::Entry* BDRCANScheduler::findEntry(uint32_t id) {
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].id == id) return &entries[i];
+    }
+    return nullptr;
+}
+
+const BDRCANScheduler::Entry* BDRCANScheduler::findEntry(uint32_t id) const {
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].id == id) return &entries[i];
+    }
+    return nullptr;
+}
@@ -0,0 +1,90 @@
+/*
+    bdrcanscheduler.h - Periodic transmit scheduler for inverter command frames.
+
+    The DTI inverter drops out of current control if Set_AC_Current / Set_Relative_Current
+    and the Drive_Enable heartbeat are not refreshed at a fixed rate. The scheduler owns the
+    timing: the sketch registers each command once, then only updates the latest setpoint.
+    */
+
+    #ifndef bdrcanscheduler_h
+    #define bdrcanscheduler_h
+    #include "Arduino.h"
+    #include <ACAN_T4.h>
+    #include "bdrcanlib.h"
+    #include "bdrcantxqueue.h"
+
+    struct ScheduleStats {
+        uint32_t sent;              // frames accepted by the controller, or handed to the queue
+        uint32_t failed;            // tryToSend rejections (retried on the next update); 0 with a queue
+        uint32_t missed;            // whole periods skipped because update() ran late
+        uint32_t maxJitterUs;       // worst lateness against the deadline
+        uint32_t avgJitterUs;       // mean lateness against the deadline
+    };
+
+    class BDRCANScheduler {
+    public:
+        BDRCANScheduler(ACAN_T4& bus = ACAN_T4::can1);
+
+        // Register a command frame; returns false if the table is full.
+        // With AUTO_PHASE, frames are spread evenly across the shortest period. A frame added
+        // after the first update() is first due on the time of the latest update(nowUs).
+        bool addPeriodic(const CanMessage& definition, uint32_t periodMs, int32_t phaseMs = AUTO_PHASE);
+
+        // Update the latest setpoint; the next scheduled frame carries it
+        bool setValue(const CanMessage& definition, float value);
+
+        // Replace the raw payload of a scheduled frame
+        bool setData(uint32_t id, const uint8_t* data, uint8_t length);
+
+        // Pause or resume a scheduled frame (phase is kept)
+        bool setEnabled(uint32_t id, bool enabled);
+
+        // Send every frame that is due; call from loop() as often as possible
+        void update();
+        void update(uint32_t nowUs);
+
+        // Hand due frames to a transmit queue at this priority instead of the bus (nullptr restores
+        // direct sends). The queue owns retries, so a queued frame counts as sent and jitter ends
+        // at the hand-over. Frames the queue later drops or expires are not seen here: read them
+        // from the queue's getStats() for this priority.
+        void setTxQueue(BDRCANTxQueue* queue, TxPriority priority = TX_SAFETY);
+
+        // Timing statistics for a scheduled frame
+        bool getStats(uint32_t id, ScheduleStats& stats) const;
+        void resetStats();
+
+        static const int MAX_ENTRIES = 8;
+        static const int32_t AUTO_PHASE = -1;
+
+    private:
+        struct Entry {
+            uint32_t id;
+            uint8_t data[8];
+            uint8_t length;
+            bool enabled;
+            bool autoPhase;
+            uint32_t periodUs;
+            uint32_t phaseUs;
+            uint32_t dueUs;
+            uint32_t sent;
+            uint32_t failed;
+            uint32_t missed;
+            uint32_t maxJitterUs;
+            uint64_t totalJitterUs;
+        };
+
+        Entry* findEntry(uint32_t id);
+        const Entry* findEntry(uint32_t id) const;
+        void spreadPhases();
+        bool sendEntry(Entry& e, uint32_t nowUs);
+
+        ACAN_T4& bus;
+        BDRCANTxQueue* txQueue = nullptr;
+        TxPriority txPriority = TX_SAFETY;
+        Entry entries[MAX_ENTRIES];
+        int entryCount = 0;
+        bool started = false;
+        uint32_t lastNowUs = 0;     // time base of the caller's update(nowUs), for frames added later
+    };
+
+#endif
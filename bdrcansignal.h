@@ -0,0 +1,313 @@
+/*
+    bdrcansignal.h - Typed accessors for single signals, specialized at compile time.
+
+    Signal<erpm>::decode(frame) reads one field with its offset, width, byte order, sign and
+    scale known to the compiler, so it inlines to a few loads and shifts without touching the
+    CanMessage table. The layout lists below mirror the table; bdrcanlib.cpp static_asserts
+    every entry against its definition.
+    */
+
+    #ifndef bdrcansignal_h
+    #define bdrcansignal_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    // Layout of one table entry, specialized for every definition below
+    template <const CanMessage& M>
+    struct SignalLayout;
+
+    #define BDRCAN_SIGNAL_LAYOUT(signal, ID, BIT_START, LENGTH, MIN, MAX, SCALE) \
+        template <> struct SignalLayout<signal> { \
+            static constexpr uint32_t id = ID; \
+            static constexpr int bitStart = BIT_START; \
+            static constexpr int length = LENGTH; \
+            static constexpr float minValue = MIN; \
+            static constexpr float maxValue = MAX; \
+            static constexpr float scale = SCALE; \
+        };
+
+    // Layout lists: X(signal, id, bit_start, length, min, max, scale), in table order
+    // Inverter commands 0x01-0x0C
+    #define BDRCAN_INVERTER_COMMAND_LAYOUTS(X) \
+        X(Set_AC_Current, 0x01, 0, 16, -3276.8f, 3276.7f, 10.0f)                \
+        X(Set_Brake_Current, 0x02, 0, 16, -3276.8f, 3276.7f, 10.0f)             \
+        X(Set_ERPM, 0x03, 0, 32, -2147483648.0f, 2147483647.0f, 1.0f)           \
+        X(Set_Position, 0x04, 0, 16, -3276.8f, 3276.7f, 10.0f)                  \
+        X(Set_Relative_Current, 0x05, 0, 16, -3276.8f, 3276.7f, 10.0f)          \
+        X(Set_Relative_Brake_Current, 0x06, 0, 16, 0.0f, 100.0f, 10.0f)         \
+        X(Set_Digital_Output_1, 0x07, 0, 1, 0.0f, 1.0f, 1.0f)                   \
+        X(Set_Digital_Output_2, 0x07, 1, 1, 0.0f, 1.0f, 1.0f)                   \
+        X(Set_Digital_Output_3, 0x07, 2, 1, 0.0f, 1.0f, 1.0f)                   \
+        X(Set_Digital_Output_4, 0x07, 3, 1, 0.0f, 1.0f, 1.0f)                   \
+        X(Max_AC_Current, 0x08, 0, 16, -3276.8f, 3276.7f, 10.0f)                \
+        X(Set_Maximum_AC_Brake_Current, 0x09, 0, 16, -3276.8f, 3276.7f, 10.0f)  \
+        X(Max_DC_Current, 0x0A, 0, 16, -3276.8f, 3276.7f, 10.0f)                \
+        X(Set_Maximum_DC_Brake_Current, 0x0B, 0, 16, -3276.8f, 3276.7f, 10.0f)  \
+        X(Drive_Enable, 0x0C, 0, 8, 0, 255, 1)
+
+    // Inverter feedback 0x20-0x35
+    #define BDRCAN_INVERTER_FEEDBACK_LAYOUTS(X) \
+        X(erpm, 0x20, 0, 32, -2147483648.0f, 2147483647.0f, 1.0f)              \
+        X(duty_cycle, 0x21, 0, 16, 0.0f, 100.0f, 10.0f)                        \
+        X(input_voltage, 0x22, 0, 16, 0.0f, 655.35f, 100.0f)                   \
+        X(AC_current, 0x23, 0, 16, -3276.8f, 3276.7f, 10.0f)                   \
+        X(DC_current, 0x24, 0, 16, -3276.8f, 3276.7f, 10.0f)                   \
+        X(RESERVED_1, 0x25, 0, 8, 0.0f, 0.0f, 1.0f)                            \
+        X(controller_temperature, 0x26, 0, 16, -40.0f, 215.0f, 10.0f)          \
+        X(motor_temperature, 0x27, 0, 16, -40.0f, 215.0f, 10.0f)               \
+        X(fault_code, 0x28, 0, 16, 0.0f, 65535.0f, 1.0f)                       \
+        X(RESERVED_2, 0x29, 0, 8, 0.0f, 0.0f, 1.0f)                            \
+        X(Id, 0x2A, 0, 16, -3276.8f, 3276.7f, 10.0f)                           \
+        X(Iq, 0x2B, 0, 16, -3276.8f, 3276.7f, 10.0f)                           \
+        X(throttle_signal, 0x2C, 0, 16, 0.0f, 100.0f, 10.0f)                   \
+        X(brake_signal, 0x2D, 0, 16, 0.0f, 100.0f, 10.0f)                      \
+        X(digital_input_1, 0x2E, 0, 1, 0.0f, 1.0f, 1.0f)                       \
+        X(digital_input_2, 0x2E, 1, 1, 0.0f, 1.0f, 1.0f)                       \
+        X(digital_input_3, 0x2E, 2, 1, 0.0f, 1.0f, 1.0f)                       \
+        X(digital_input_4, 0x2E, 3, 1, 0.0f, 1.0f, 1.0f)                       \
+        X(digital_input_1_2, 0x2F, 0, 1, 0.0f, 1.0f, 1.0f)                     \
+        X(digital_input_2_2, 0x2F, 1, 1, 0.0f, 1.0f, 1.0f)                     \
+        X(digital_input_3_2, 0x2F, 2, 1, 0.0f, 1.0f, 1.0f)                     \
+        X(digital_input_4_2, 0x2F, 3, 1, 0.0f, 1.0f, 1.0f)                     \
+        X(drive_enable, 0x30, 0, 8, 0.0f, 1.0f, 1.0f)                          \
+        X(capacitor_temp_limit, 0x31, 0, 1, 0.0f, 1.0f, 1.0f)                  \
+        X(DC_current_limit, 0x31, 1, 1, 0.0f, 1.0f, 1.0f)                      \
+        X(drive_enable_limit, 0x31, 2, 1, 0.0f, 1.0f, 1.0f)                    \
+        X(igbt_acceleration_temperature_limit, 0x31, 3, 1, 0.0f, 1.0f, 1.0f)   \
+        X(igbt_temperature_limit, 0x31, 4, 1, 0.0f, 1.0f, 1.0f)                \
+        X(input_voltage_limit, 0x31, 5, 1, 0.0f, 1.0f, 1.0f)                   \
+        X(motor_acceleration_temperature_limit, 0x31, 6, 1, 0.0f, 1.0f, 1.0f)  \
+        X(motor_temperature_limit, 0x31, 7, 1, 0.0f, 1.0f, 1.0f)               \
+        X(RPM_min_limit, 0x32, 0, 1, 0.0f, 1.0f, 1.0f)                         \
+        X(RPM_max_limit, 0x32, 1, 1, 0.0f, 1.0f, 1.0f)                         \
+        X(power_limit, 0x32, 2, 1, 0.0f, 1.0f, 1.0f)                           \
+        X(reserved_3, 0x33, 0, 8, 0.0f, 0.0f, 1.0f)                            \
+        X(reserved_4, 0x34, 0, 8, 0.0f, 0.0f, 1.0f)                            \
+        X(CAN_map_version, 0x35, 0, 16, 0.0f, 65535.0f, 1.0f)
+
+    // Orion BMS single-value PIDs 0xF004-0xF04F
+    #define BDRCAN_BMS_STATUS_LAYOUTS(X) \
+        X(relays_status, 0xF004, 0, 16, 0.0f, 65535.0f, 1.0f)                 \
+        X(max_cells_supported_count, 0xF006, 0, 8, 0.0f, 255.0f, 1.0f)        \
+        X(populated_cell_count, 0xF007, 0, 8, 0.0f, 255.0f, 1.0f)             \
+        X(pack_charge_current_limit, 0xF00A, 0, 16, 0.0f, 65535.0f, 1.0f)     \
+        X(pack_discharge_current_limit, 0xF00B, 0, 16, 0.0f, 65535.0f, 1.0f)  \
+        X(signed_pack_current, 0xF00C, 0, 16, -3276.8f, 3276.7f, 0.1f)        \
+        X(unsigned_pack_current, 0xF015, 0, 16, 0.0f, 6553.5f, 0.1f)          \
+        X(pack_voltage, 0xF00D, 0, 16, 0.0f, 6553.5f, 0.1f)                   \
+        X(pack_open_voltage, 0xF00E, 0, 16, 0.0f, 6553.5f, 0.1f)              \
+        X(pack_state_of_charge, 0xF00F, 0, 8, 0.0f, 100.0f, 0.5f)             \
+        X(pack_amphours, 0xF010, 0, 16, 0.0f, 6553.5f, 0.1f)                  \
+        X(pack_resistance, 0xF011, 0, 16, 0.0f, 655.35f, 0.01f)               \
+        X(pack_depth_of_discharge, 0xF012, 0, 8, 0.0f, 100.0f, 0.5f)          \
+        X(pack_health, 0xF013, 0, 8, 0.0f, 100.0f, 1.0f)                      \
+        X(pack_summed_voltage, 0xF014, 0, 16, 0.0f, 655.35f, 0.01f)           \
+        X(total_pack_cycles, 0xF018, 0, 16, 0.0f, 65535.0f, 1.0f)             \
+        X(highest_pack_temperature, 0xF028, 0, 8, -40.0f, 80.0f, 1.0f)        \
+        X(lowest_pack_temperature, 0xF029, 0, 8, -40.0f, 80.0f, 1.0f)         \
+        X(avg_pack_temperature, 0xF02A, 0, 8, -40.0f, 80.0f, 1.0f)            \
+        X(heatsink_temperature_sensor, 0xF02D, 0, 8, -40.0f, 80.0f, 1.0f)     \
+        X(fan_speed, 0xF02B, 0, 8, 0.0f, 6.0f, 1.0f)                          \
+        X(requested_fan_speed, 0xF02C, 0, 8, 0.0f, 6.0f, 1.0f)                \
+        X(low_cell_voltage, 0xF032, 0, 16, 0.0f, 5.0f, 0.0001f)               \
+        X(low_cell_voltage_id, 0xF03E, 0, 16, 0.0f, 180.0f, 1.0f)             \
+        X(high_cell_voltage, 0xF033, 0, 16, 0.0f, 5.0f, 0.0001f)              \
+        X(high_cell_voltage_id, 0xF03D, 0, 16, 0.0f, 180.0f, 1.0f)            \
+        X(avg_cell_voltage, 0xF034, 0, 16, 0.0f, 5.0f, 0.0001f)               \
+        X(low_opencell_voltage, 0xF035, 0, 16, 0.0f, 5.0f, 0.0001f)           \
+        X(low_opencell_voltage_id, 0xF040, 0, 16, 0.0f, 180.0f, 1.0f)         \
+        X(high_opencell_voltage, 0xF036, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(high_opencell_voltage_id, 0xF03F, 0, 16, 0.0f, 180.0f, 1.0f)        \
+        X(avg_opencell_voltage, 0xF037, 0, 16, 0.0f, 5.0f, 0.0001f)           \
+        X(low_cell_resistance, 0xF038, 0, 16, 0.0f, 655.35f, 0.01f)           \
+        X(low_cell_resistance_id, 0xF042, 0, 16, 0.0f, 180.0f, 1.0f)          \
+        X(high_cell_resistance, 0xF039, 0, 16, 0.0f, 655.35f, 0.01f)          \
+        X(high_cell_resistance_id, 0xF041, 0, 16, 0.0f, 180.0f, 1.0f)         \
+        X(avg_cell_resistance, 0xF03A, 0, 16, 0.0f, 655.35f, 0.01f)           \
+        X(input_power_supply_voltage, 0xF046, 0, 16, 0.0f, 35.0f, 0.1f)       \
+        X(fan_voltage, 0xF049, 0, 16, 0.0f, 15.0f, 0.01f)
+
+    // Orion BMS 12-cell arrays 0xF100-0xF30E
+    #define BDRCAN_BMS_CELL_LAYOUTS(X) \
+        X(cell_voltages_1_12, 0xF100, 0, 16, 0.0f, 5.0f, 0.0001f)             \
+        X(cell_voltages_13_24, 0xF101, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_25_36, 0xF102, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_37_48, 0xF103, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_49_60, 0xF104, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_61_72, 0xF105, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_73_84, 0xF106, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_85_96, 0xF107, 0, 16, 0.0f, 5.0f, 0.0001f)            \
+        X(cell_voltages_97_108, 0xF108, 0, 16, 0.0f, 5.0f, 0.0001f)           \
+        X(cell_voltages_109_120, 0xF109, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(cell_voltages_121_132, 0xF10A, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(cell_voltages_133_144, 0xF10B, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(cell_voltages_145_156, 0xF10C, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(cell_voltages_157_168, 0xF10D, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(cell_voltages_169_180, 0xF10E, 0, 16, 0.0f, 5.0f, 0.0001f)          \
+        X(opencell_voltages_1_12, 0xF300, 0, 16, 0.0f, 5.0f, 0.0001f)         \
+        X(opencell_voltages_13_24, 0xF301, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_25_36, 0xF302, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_37_48, 0xF303, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_49_60, 0xF304, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_61_72, 0xF305, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_73_84, 0xF306, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_85_96, 0xF307, 0, 16, 0.0f, 5.0f, 0.0001f)        \
+        X(opencell_voltages_97_108, 0xF308, 0, 16, 0.0f, 5.0f, 0.0001f)       \
+        X(opencell_voltages_109_120, 0xF309, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(opencell_voltages_121_132, 0xF30A, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(opencell_voltages_133_144, 0xF30B, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(opencell_voltages_145_156, 0xF30C, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(opencell_voltages_157_168, 0xF30D, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(opencell_voltages_169_180, 0xF30E, 0, 16, 0.0f, 5.0f, 0.0001f)      \
+        X(internal_resistances_1_12, 0xF200, 0, 16, 0.0f, 327.67f, 0.01f)     \
+        X(internal_resistances_13_24, 0xF201, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_25_36, 0xF202, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_37_48, 0xF203, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_49_60, 0xF204, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_61_72, 0xF205, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_73_84, 0xF206, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_85_96, 0xF207, 0, 16, 0.0f, 327.67f, 0.01f)    \
+        X(internal_resistances_97_108, 0xF208, 0, 16, 0.0f, 327.67f, 0.01f)   \
+        X(internal_resistances_109_120, 0xF209, 0, 16, 0.0f, 327.67f, 0.01f)  \
+        X(internal_resistances_121_132, 0xF20A, 0, 16, 0.0f, 327.67f, 0.01f)  \
+        X(internal_resistances_133_144, 0xF20B, 0, 16, 0.0f, 327.67f, 0.01f)  \
+        X(internal_resistances_145_156, 0xF20C, 0, 16, 0.0f, 327.67f, 0.01f)  \
+        X(internal_resistances_157_168, 0xF20D, 0, 16, 0.0f, 327.67f, 0.01f)  \
+        X(internal_resistances_169_180, 0xF20E, 0, 16, 0.0f, 327.67f, 0.01f)
+
+    #if BDRCAN_INVERTER_COMMANDS
+    BDRCAN_INVERTER_COMMAND_LAYOUTS(BDRCAN_SIGNAL_LAYOUT)
+    #endif
+
+    #if BDRCAN_INVERTER_FEEDBACK
+    BDRCAN_INVERTER_FEEDBACK_LAYOUTS(BDRCAN_SIGNAL_LAYOUT)
+    #endif
+
+    #if BDRCAN_BMS_STATUS
+    BDRCAN_BMS_STATUS_LAYOUTS(BDRCAN_SIGNAL_LAYOUT)
+    #endif
+
+    #if BDRCAN_BMS_CELLS
+    BDRCAN_BMS_CELL_LAYOUTS(BDRCAN_SIGNAL_LAYOUT)
+    #endif
+
+    // Raw field type: sign extended when the minimum is negative
+    template <bool Signed>
+    struct SignalRawType { typedef uint32_t type; };
+
+    template <>
+    struct SignalRawType<true> { typedef int32_t type; };
+
+    // Decoded type: bool for one-bit flags, the raw integer for unscaled fields, float otherwise
+    template <bool Flag, bool Unscaled, typename Raw>
+    struct SignalValueType { typedef float type; };
+
+    template <typename Raw>
+    struct SignalValueType<true, true, Raw> { typedef bool type; };
+
+    template <typename Raw>
+    struct SignalValueType<false, true, Raw> { typedef Raw type; };
+
+    template <const CanMessage& M>
+    struct Signal {
+        typedef SignalLayout<M> Layout;
+
+        static constexpr uint32_t id = Layout::id;
+        static constexpr bool bms = Layout::id >= 0xF000;      // big-endian whole bytes, multiplied by scale
+        static constexpr bool isSigned = Layout::minValue < 0;
+
+        // Bytes of payload the field reaches into; the DLC must be at least this
+        static constexpr int bytes = bms ? (Layout::bitStart + Layout::length) / 8
+                                         : (Layout::bitStart + Layout::length + 7) / 8;
+
+        typedef typename SignalRawType<isSigned>::type RawType;
+        typedef typename SignalValueType<Layout::length == 1, Layout::scale == 1.0f, RawType>::type Type;
+
+        // Unchecked reads: data must hold the field. element picks an entry of a BMS array payload.
+        // raw() is the fixed-point field (value = raw / scale, or raw * scale for the BMS).
+        static inline RawType raw(const uint8_t* data, int element = 0) {
+            uint32_t bits = bms ? bigEndian(data + element * (Layout::length / 8)) : littleEndian(data);
+            return extend(bits);
+        }
+
+        // Same arithmetic and clamping as interpretInverterMessage / interpretBMSMessage
+        static inline float value(const uint8_t* data, int element = 0) {
+            float scaled = bms ? (float)raw(data, element) * Layout::scale
+                               : (float)raw(data, element) / Layout::scale;
+            if (scaled < Layout::minValue) scaled = Layout::minValue;
+            if (scaled > Layout::maxValue) scaled = Layout::maxValue;
+            return scaled;
+        }
+
+        static inline Type decode(const uint8_t* data, int element = 0) {
+            return convert(data, element, (Type*)nullptr);
+        }
+
+        // Checked reads: the frame must have this ID and be at least bytes long
+        static inline bool carries(const messageStruct& msg) {
+            return msg.id == id && msg.length >= bytes;
+        }
+
+        // Type() if the frame does not carry the field
+        static inline Type decode(const messageStruct& msg) {
+            return carries(msg) ? decode(msg.data) : Type();
+        }
+
+        static inline bool tryDecode(const messageStruct& msg, Type* out) {
+            if (!carries(msg)) return false;
+            *out = decode(msg.data);
+            return true;
+        }
+
+    private:
+        static constexpr int byteIndex = Layout::bitStart / 8;
+        static constexpr int bitOffset = Layout::bitStart % 8;
+
+        // At most 5 bytes (32 bits at a bit offset of 7); the span is a constant, so the reads unroll
+        static constexpr int span = bms ? Layout::length / 8 : (Layout::length + bitOffset + 7) / 8;
+
+        static inline uint32_t littleEndian(const uint8_t* data) {
+            const uint8_t* p = data + byteIndex;
+            uint64_t field = p[0];
+            if (span > 1) field |= (uint64_t)p[1] << 8;
+            if (span > 2) field |= (uint64_t)p[2] << 16;
+            if (span > 3) field |= (uint64_t)p[3] << 24;
+            if (span > 4) field |= (uint64_t)p[4] << 32;
+            return (uint32_t)(field >> bitOffset);
+        }
+
+        static inline uint32_t bigEndian(const uint8_t* data) {
+            const uint8_t* p = data + byteIndex;
+            uint32_t field = p[0];
+            if (span > 1) field = (field << 8) | p[1];
+            if (span > 2) field = (field << 8) | p[2];
+            if (span > 3) field = (field << 8) | p[3];
+            return field;
+        }
+
+        static inline RawType extend(uint32_t bits) {
+            if (Layout::length >= 32) return (RawType)bits;
+            uint32_t mask = (1UL << (Layout::length & 31)) - 1;
+            bits &= mask;
+            if (isSigned && (bits & (1UL << ((Layout::length - 1) & 31)))) bits |= ~mask;
+            return (RawType)bits;
+        }
+
+        // Picked by the decoded type
+        static inline float convert(const uint8_t* data, int element, float*) {
+            return value(data, element);
+        }
+
+        static inline bool convert(const uint8_t* data, int element, bool*) {
+            return raw(data, element) != 0;
+        }
+
+        static inline RawType convert(const uint8_t* data, int element, RawType*) {
+            int64_t field = raw(data, element);
+            if (field < (int64_t)Layout::minValue) field = (int64_t)Layout::minValue;
+            if (field > (int64_t)Layout::maxValue) field = (int64_t)Layout::maxValue;
+            return (RawType)field;
+        }
+    };
+
+#endif
@@ -0,0 +1,167 @@
+#include "Arduino.h"
+#include "bdrcantxqueue.h"
+
+BDRCANTxQueue::BDRCANTxQueue(ACAN_T4& bus) : bus(bus) {
+    clear();
+    resetStats();
+    for (int p = 0; p < TX_PRIORITY_COUNT; p++) classes[p].maxWaitUs = 0;
+    classes[TX_SAFETY].coalesce = COALESCE_ID;
+    classes[TX_CONTROL].coalesce = COALESCE_ID;
+    // Every OBD2 request shares 0x7DF, so polling can only merge repeats of the same PID
+    classes[TX_POLLING].coalesce = COALESCE_FRAME;
+}
+
+bool BDRCANTxQueue::send(const CANMessage& frame, TxPriority priority) {
+    // Waits are measured in the time base update() runs on
+    return send(frame, priority, callerClock ? lastNowUs : micros());
+}
+
+bool BDRCANTxQueue::send(const CANMessage& frame, TxPriority priority, uint32_t nowUs) {
+    if (priority >= TX_PRIORITY_COUNT || frame.len > 8) return false;
+    TxClass& c = classes[priority];
+
+    Slot* queued = (c.coalesce == COALESCE_NONE) ? nullptr : findQueued(c, frame.id);
+    if (queued != nullptr) {
+        if (c.coalesce == COALESCE_ID) {
+            // Latest setpoint wins; the frame keeps its place and its original wait
+            queued->frame = frame;
+            c.coalesced++;
+            return true;
+        }
+        if (queued->frame.len == frame.len && memcmp(queued->frame.data, frame.data, frame.len) == 0) {
+            c.coalesced++;
+            return true;
+        }
+    }
+
+    if (c.count == CLASS_DEPTH) {
+        popHead(c);
+        c.dropped++;
+    }
+
+    Slot& slot = c.slots[(c.head + c.count) % CLASS_DEPTH];
+    slot.frame = frame;
+    slot.queuedUs = nowUs;
+    c.count++;
+    c.queued++;
+    if (c.count > c.maxDepth) c.maxDepth = c.count;
+    return true;
+}
+
+bool BDRCANTxQueue::send(uint32_t id, const uint8_t* data, uint8_t length, TxPriority priority) {
+    if (data == nullptr || length > 8) return false;
+    CANMessage frame;
+    frame.id = id;
+    frame.ext = false;
+    frame.len = length;
+    memset(frame.data, 0, sizeof(frame.data));
+    memcpy(frame.data, data, length);
+    return send(frame, priority);
+}
+
+void BDRCANTxQueue::update() {
+    update(micros());
+    callerClock = false;
+}
+
+void BDRCANTxQueue::update(uint32_t nowUs) {
+    callerClock = true;
+    lastNowUs = nowUs;
+    for (int p = 0; p < TX_PRIORITY_COUNT; p++) {
+        TxClass& c = classes[p];
+        while (c.count > 0) {
+            Slot& slot = c.slots[c.head];
+            uint32_t waitUs = nowUs - slot.queuedUs;
+
+            if (c.maxWaitUs != 0 && waitUs > c.maxWaitUs) {
+                popHead(c);
+                c.expired++;
+                continue;
+            }
+
+            // Mailboxes full: nothing below this frame may overtake it, retry on the next update
+            if (!bus.tryToSend(slot.frame)) {
+                c.retries++;
+                return;
+            }
+
+            popHead(c);
+            c.sent++;
+            c.totalWaitUs += waitUs;
+            if (waitUs > c.maxWaitSeenUs) c.maxWaitSeenUs = waitUs;
+        }
+    }
+}
+
+void BDRCANTxQueue::setCoalesce(TxPriority priority, TxCoalesce mode) {
+    if (priority >= TX_PRIORITY_COUNT) return;
+    classes[priority].coalesce = mode;
+}
+
+void BDRCANTxQueue::setMaxWait(TxPriority priority, uint32_t maxWaitUs) {
+    if (priority >= TX_PRIORITY_COUNT) return;
+    classes[priority].maxWaitUs = maxWaitUs;
+}
+
+int BDRCANTxQueue::depth(TxPriority priority) const {
+    return (priority < TX_PRIORITY_COUNT) ? classes[priority].count : 0;
+}
+
+bool BDRCANTxQueue::isEmpty() const {
+    for (int p = 0; p < TX_PRIORITY_COUNT; p++) {
+        if (classes[p].count > 0) return false;
+    }
+    return true;
+}
+
+bool BDRCANTxQueue::getStats(TxPriority priority, TxClassStats& stats) const {
+    if (priority >= TX_PRIORITY_COUNT) return false;
+    const TxClass& c = classes[priority];
+    stats.depth = c.count;
+    stats.maxDepth = c.maxDepth;
+    stats.queued = c.queued;
+    stats.sent = c.sent;
+    stats.coalesced = c.coalesced;
+    stats.dropped = c.dropped;
+    stats.expired = c.expired;
+    stats.retries = c.retries;
+    stats.maxWaitUs = c.maxWaitSeenUs;
+    stats.avgWaitUs = c.sent ? (uint32_t)(c.totalWaitUs / c.sent) : 0;
+    return true;
+}
+
+void BDRCANTxQueue::resetStats() {
+    for (int p = 0; p < TX_PRIORITY_COUNT; p++) {
+        TxClass& c = classes[p];
+        c.maxDepth = c.count;
+        c.queued = 0;
+        c.sent = 0;
+        c.coalesced = 0;
+        c.dropped = 0;
+        c.expired = 0;
+        c.retries = 0;
+        c.maxWaitSeenUs = 0;
+        c.totalWaitUs = 0;
+    }
+}
+
+void BDRCANTxQueue::clear() {
+    for (int p = 0; p < TX_PRIORITY_COUNT; p++) {
+        classes[p].head = 0;
+        classes[p].count = 0;
+    }
+}
+
+// Newest queued frame with this ID
+BDRCANTxQueue::Slot* BDRCANTxQueue::findQueued(TxClass& c, uint32_t id) {
+    for (int i = c.count - 1; i >= 0; i--) {
+        Slot& slot = c.slots[(c.head + i) % CLASS_DEPTH];
+        if (slot.frame.id == id) return &slot;
+    }
+    return nullptr;
+}
+
+void BDRCANTxQueue::popHead(TxClass& c) {
+    c.head = (c.head + 1) % CLASS_DEPTH;
+    c.count--;
+}
@@ -0,0 +1,102 @@
+/*
+    bdrcantxqueue.h - Bounded transmit queue with priority classes.
+
+    tryToSend fails whenever the controller's mailboxes are full, and a frame that is not
+    retried is lost. The queue keeps frames until they go out: safety commands first, BMS
+    polling last. A new setpoint replaces a queued one for the same ID instead of queueing
+    behind it, and a full class pushes out its oldest frame.
+    */
+
+    #ifndef bdrcantxqueue_h
+    #define bdrcantxqueue_h
+    #include "Arduino.h"
+    #include <ACAN_T4.h>
+
+    // Served in this order; a lower class only sends while every class above it is empty
+    enum TxPriority : uint8_t {
+        TX_SAFETY,          // Drive_Enable, current / speed setpoints
+        TX_CONTROL,         // other commands, ISO-TP flow control
+        TX_POLLING,         // OBD2 requests to the BMS
+        TX_PRIORITY_COUNT
+    };
+
+    // What a frame with the same ID as a queued one does
+    enum TxCoalesce : uint8_t {
+        COALESCE_NONE,      // queued behind it
+        COALESCE_ID,        // replaces its payload, keeps its place in line
+        COALESCE_FRAME      // dropped if the payload is identical, else queued
+    };
+
+    struct TxClassStats {
+        uint8_t depth;              // frames queued now
+        uint8_t maxDepth;           // high-water mark
+        uint32_t queued;            // frames accepted by send()
+        uint32_t sent;              // frames accepted by the controller
+        uint32_t coalesced;         // merged into a queued frame
+        uint32_t dropped;           // oldest frame pushed out of a full class
+        uint32_t expired;           // waited longer than the class limit
+        uint32_t retries;           // tryToSend rejections (mailboxes full)
+        uint32_t maxWaitUs;         // longest enqueue-to-send time
+        uint32_t avgWaitUs;         // mean enqueue-to-send time
+    };
+
+    class BDRCANTxQueue {
+    public:
+        BDRCANTxQueue(ACAN_T4& bus = ACAN_T4::can1);
+
+        // Queue a frame; false only for a bad class or length. Never blocks. Without nowUs the
+        // frame is stamped with micros(), or with the latest update(nowUs) if the caller drives time.
+        bool send(const CANMessage& frame, TxPriority priority);
+        bool send(const CANMessage& frame, TxPriority priority, uint32_t nowUs);
+        bool send(uint32_t id, const uint8_t* data, uint8_t length, TxPriority priority);
+
+        // Hand queued frames to the controller until its mailboxes are full; call from loop()
+        void update();
+        void update(uint32_t nowUs);
+
+        // Per-class behaviour. Defaults: safety and control coalesce by ID, polling drops
+        // identical requests; no class expires frames (maxWaitUs = 0).
+        void setCoalesce(TxPriority priority, TxCoalesce mode);
+        void setMaxWait(TxPriority priority, uint32_t maxWaitUs);
+
+        int depth(TxPriority priority) const;
+        bool isEmpty() const;
+        bool getStats(TxPriority priority, TxClassStats& stats) const;
+        void resetStats();
+        void clear();
+
+        static const int CLASS_DEPTH = 8;
+
+    private:
+        struct Slot {
+            CANMessage frame;
+            uint32_t queuedUs;
+        };
+
+        struct TxClass {
+            Slot slots[CLASS_DEPTH];
+            uint8_t head;
+            uint8_t count;
+            uint8_t maxDepth;
+            TxCoalesce coalesce;
+            uint32_t maxWaitUs;
+            uint32_t queued;
+            uint32_t sent;
+            uint32_t coalesced;
+            uint32_t dropped;
+            uint32_t expired;
+            uint32_t retries;
+            uint32_t maxWaitSeenUs;
+            uint64_t totalWaitUs;
+        };
+
+        Slot* findQueued(TxClass& c, uint32_t id);
+        void popHead(TxClass& c);
+
+        ACAN_T4& bus;
+        TxClass classes[TX_PRIORITY_COUNT];
+        bool callerClock = false;       // update(nowUs) was called directly
+        uint32_t lastNowUs = 0;
+    };
+
+#endif
@@ -0,0 +1,273 @@
+/*
+    DecoderFuzz - random-driven property check of the BDRCANLib decoders.
+
+    Every message definition is fed random payloads and the result of the library's
+    decoders (interpretInverterMessage, interpretBMSMessage, decodeFrame) is compared
+    bit-for-bit against a slow reference decoder that walks the payload one bit at a time.
+    A quarter of the frames get a random DLC of 0-8: fields past it must be rejected by
+    extractRaw and left out by decodeFrame. Values are also round-tripped through
+    encodeInverterValue / encodeBMSValue.
+
+    The seed is fixed, so the printed digest only changes if decoded results change:
+    run it before and after touching the decoders and compare the digest and the
+    decode throughput lines.
+    */
+
+#include <bdrcanlib.h>
+
+static const uint32_t SEED = 0xBD12C0DE;
+static const uint32_t ITERATIONS_PER_MESSAGE = 2000;
+static const uint32_t THROUGHPUT_FRAMES = 20000;
+
+BDRCANLib canLib;
+static uint32_t rngState = SEED;
+static uint32_t digest = 2166136261UL;
+static uint32_t mismatches = 0;
+static uint32_t roundTripFailures = 0;
+static uint32_t shortFrames = 0;
+static volatile float throughputSink;
+
+static uint32_t nextRandom() {
+    // xorshift32: deterministic across boards and runs
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static void addToDigest(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        digest ^= (bits >> (i * 8)) & 0xFF;
+        digest *= 16777619UL;
+    }
+}
+
+static bool readBit(const messageStruct& msg, int position) {
+    return (msg.data[position / 8] >> (position % 8)) & 1;
+}
+
+// Fields with a negative minimum are two's complement, everything else is unsigned
+static float signedValue(uint32_t raw, const CanMessage& def) {
+    if (def.min >= 0) return (float)raw;
+    if (def.length < 32 && (raw & (1UL << (def.length - 1)))) {
+        raw |= ~((1UL << def.length) - 1);
+    }
+    return (float)(int32_t)raw;
+}
+
+// Whether the frame's DLC reaches the last byte of the field
+static bool referenceCarries(const messageStruct& msg, const CanMessage& def) {
+    int lastBit = BDRCANLib::isBMSMessage(&def) ? (def.bit_start / 8 + def.length / 8) * 8 - 1
+                                                : def.bit_start + def.length - 1;
+    return lastBit / 8 < msg.length;
+}
+
+// Reference inverter decoder: little-endian bit field, sign-extended when min is negative
+static float referenceInverter(const messageStruct& msg, const CanMessage& def) {
+    uint32_t raw = 0;
+    for (int k = 0; k < def.length && k < 32; k++) {
+        if (def.bit_start + k < 64 && readBit(msg, def.bit_start + k)) raw |= 1UL << k;
+    }
+    float scaled = signedValue(raw, def) / def.scale;
+    if (scaled < def.min) scaled = def.min;
+    if (scaled > def.max) scaled = def.max;
+    return scaled;
+}
+
+// Reference BMS decoder: big-endian whole bytes, sign-extended when min is negative
+static float referenceBMS(const messageStruct& msg, const CanMessage& def) {
+    int byteIndex = def.bit_start / 8;
+    int lengthBytes = def.length / 8;
+
+    uint32_t raw = 0;
+    for (int k = 0; k < lengthBytes * 8 && k < 32; k++) {
+        int position = (byteIndex + k / 8) * 8 + (7 - k % 8);
+        raw = (raw << 1) | (readBit(msg, position) ? 1 : 0);
+    }
+    float scaled = signedValue(raw, def) * def.scale;
+    if (scaled < def.min) scaled = def.min;
+    if (scaled > def.max) scaled = def.max;
+    return scaled;
+}
+
+static bool sameBits(float a, float b) {
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// With randomLength, one frame in four gets a DLC of 0-8 (short and odd lengths included)
+static void randomFrame(messageStruct& msg, uint32_t id, bool randomLength) {
+    msg.id = id;
+    msg.length = BDRCANLib::defmeslen;
+    if (randomLength && (nextRandom() & 3) == 0) {
+        msg.length = nextRandom() % (BDRCANLib::defmeslen + 1);
+        if (msg.length < BDRCANLib::defmeslen) shortFrames++;
+    }
+    for (int i = 0; i < 8; i++) msg.data[i] = nextRandom() & 0xFF;
+}
+
+static void reportMismatch(const char* what, const CanMessage& def, float expected, float actual) {
+    mismatches++;
+    Serial.print("MISMATCH ");
+    Serial.print(what);
+    Serial.print(" ");
+    Serial.print(def.name);
+    Serial.print(" expected ");
+    Serial.print(expected, 6);
+    Serial.print(" got ");
+    Serial.println(actual, 6);
+}
+
+static void checkDecoders(const CanMessage& def) {
+    bool bms = BDRCANLib::isBMSMessage(&def);
+    messageStruct msg;
+
+    for (uint32_t n = 0; n < ITERATIONS_PER_MESSAGE; n++) {
+        randomFrame(msg, def.id, true);
+
+        // A field past the DLC must be rejected, never decoded from stale bytes
+        int64_t raw;
+        bool carried = referenceCarries(msg, def);
+        if (BDRCANLib::extractRaw(msg, def, &raw) != carried) {
+            mismatches++;
+            Serial.print("MISMATCH extractRaw ");
+            Serial.print(def.name);
+            Serial.print(" DLC ");
+            Serial.print(msg.length);
+            Serial.println(carried ? " rejected a carried field" : " accepted a missing field");
+            return;
+        }
+        if (!carried) continue;
+
+        float expected = bms ? referenceBMS(msg, def) : referenceInverter(msg, def);
+        float actual = bms ? canLib.interpretBMSMessage(msg, def) : canLib.interpretInverterMessage(msg, def);
+        addToDigest(actual);
+        if (!sameBits(expected, actual)) {
+            reportMismatch("decode", def, expected, actual);
+            return;
+        }
+
+        // Round trip: a value inside min/max must come back within half a scale step
+        float span = def.max - def.min;
+        float value = def.min + span * (float)(nextRandom() % 10001) / 10000.0f;
+        memset(msg.data, 0, sizeof(msg.data));
+        msg.length = BDRCANLib::defmeslen;
+        if (bms) {
+            BDRCANLib::encodeBMSValue(value, def, msg.data);
+        } else {
+            BDRCANLib::encodeInverterValue(value, def, msg.data);
+        }
+        float decoded = bms ? canLib.interpretBMSMessage(msg, def) : canLib.interpretInverterMessage(msg, def);
+        float step = bms ? def.scale : 1.0f / def.scale;
+        float tolerance = step / 2 + fabsf(value) * 1e-6f;
+        if (fabsf(decoded - value) > tolerance) {
+            roundTripFailures++;
+            Serial.print("ROUND TRIP ");
+            Serial.print(def.name);
+            Serial.print(" wrote ");
+            Serial.print(value, 6);
+            Serial.print(" read ");
+            Serial.println(decoded, 6);
+            return;
+        }
+    }
+}
+
+// decodeFrame must agree with decoding each signal of the slot on its own, and return
+// exactly the signals the DLC carries
+static void checkFrameDecode(int slot) {
+    int count;
+    const CanMessage* const* defs = BDRCANLib::getSlotMessages(slot, &count);
+    float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+    messageStruct msg;
+
+    for (uint32_t n = 0; n < ITERATIONS_PER_MESSAGE / 10; n++) {
+        randomFrame(msg, defs[0]->id, true);
+        int written = canLib.decodeFrame(msg, values, BDRCANLib::MAX_SIGNALS_PER_ID);
+        int carried = 0;
+        for (int i = 0; i < count; i++) {
+            if (referenceCarries(msg, *defs[i])) carried++;
+        }
+        if (written != carried) {
+            mismatches++;
+            Serial.print("MISMATCH decodeFrame ");
+            Serial.print(defs[0]->name);
+            Serial.print(" DLC ");
+            Serial.print(msg.length);
+            Serial.print(" wrote ");
+            Serial.print(written);
+            Serial.print(" of ");
+            Serial.print(carried);
+            Serial.println(" carried fields");
+            return;
+        }
+        for (int i = 0; i < written; i++) {
+            if (!referenceCarries(msg, *defs[i])) {
+                reportMismatch("decodeFrame past DLC", *defs[i], 0.0f, values[i]);
+                return;
+            }
+            float expected = BDRCANLib::isBMSMessage(defs[i]) ? referenceBMS(msg, *defs[i])
+                                                              : referenceInverter(msg, *defs[i]);
+            if (!sameBits(expected, values[i])) {
+                reportMismatch("decodeFrame", *defs[i], expected, values[i]);
+                return;
+            }
+        }
+    }
+}
+
+static void measureThroughput(bool bms) {
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    messageStruct msg;
+    uint32_t decoded = 0;
+
+    uint32_t start = micros();
+    for (uint32_t n = 0; n < THROUGHPUT_FRAMES; n++) {
+        const CanMessage& def = *all[n % count];
+        if (BDRCANLib::isBMSMessage(&def) != bms) continue;
+        randomFrame(msg, def.id, false);
+        throughputSink = bms ? canLib.interpretBMSMessage(msg, def) : canLib.interpretInverterMessage(msg, def);
+        decoded++;
+    }
+    uint32_t elapsed = micros() - start;
+
+    Serial.print(bms ? "interpretBMSMessage: " : "interpretInverterMessage: ");
+    Serial.print(decoded);
+    Serial.print(" decodes in ");
+    Serial.print(elapsed);
+    Serial.print(" us (");
+    Serial.print(elapsed ? (float)decoded / elapsed : 0.0f, 3);
+    Serial.println(" M decodes/s, includes payload generation)");
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000) {
+    }
+
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    for (int i = 0; i < count; i++) {
+        checkDecoders(*all[i]);
+    }
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        checkFrameDecode(slot);
+    }
+
+    Serial.print("decode mismatches: ");
+    Serial.println(mismatches);
+    Serial.print("round trip failures: ");
+    Serial.println(roundTripFailures);
+    Serial.print("short frames: ");
+    Serial.println(shortFrames);
+    Serial.print("result digest: 0x");
+    Serial.println(digest, HEX);
+
+    measureThroughput(false);
+    measureThroughput(true);
+}
+
+void loop() {
+}
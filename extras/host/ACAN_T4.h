@@ -0,0 +1,83 @@
+/*
+    ACAN_T4.h - Host stand-in for the ACAN_T4 driver.
+
+    Frames go through a pluggable CANBackend. With no backend, sends fail and nothing is
+    received; HostLoopback echoes sent frames back into the receive queue, which is enough to
+    run the scheduler and ISO-TP code on a PC.
+    */
+
+    #ifndef bdrcan_host_acan_t4_h
+    #define bdrcan_host_acan_t4_h
+    #include <stdint.h>
+    #include <string.h>
+
+    class CANMessage {
+    public:
+        uint32_t id = 0;
+        bool ext = false;
+        bool rtr = false;
+        uint8_t idx = 0;
+        uint8_t len = 0;
+        union {
+            uint64_t data64;
+            uint32_t data32[2];
+            uint16_t data16[4];
+            uint8_t data[8];
+        };
+
+        CANMessage() : data64(0) {}
+    };
+
+    class CANBackend {
+    public:
+        virtual ~CANBackend() {}
+        virtual bool send(const CANMessage& frame) = 0;
+        virtual bool receive(CANMessage& frame) = 0;
+        virtual bool available() = 0;
+    };
+
+    // Fixed ring: a full ring rejects sends the way full mailboxes do
+    class HostLoopback : public CANBackend {
+    public:
+        bool send(const CANMessage& frame) override {
+            if (count == CAPACITY) return false;
+            ring[(head + count) % CAPACITY] = frame;
+            count++;
+            return true;
+        }
+
+        bool receive(CANMessage& frame) override {
+            if (count == 0) return false;
+            frame = ring[head];
+            head = (head + 1) % CAPACITY;
+            count--;
+            return true;
+        }
+
+        bool available() override { return count != 0; }
+
+        static const int CAPACITY = 64;
+
+    private:
+        CANMessage ring[CAPACITY];
+        int head = 0;
+        int count = 0;
+    };
+
+    class ACAN_T4 {
+    public:
+        static ACAN_T4 can1;
+        static ACAN_T4 can2;
+        static ACAN_T4 can3;
+
+        void setBackend(CANBackend* backend) { this->backend = backend; }
+
+        bool tryToSend(const CANMessage& frame) { return backend != nullptr && backend->send(frame); }
+        bool receive(CANMessage& frame) { return backend != nullptr && backend->receive(frame); }
+        bool available() { return backend != nullptr && backend->available(); }
+
+    private:
+        CANBackend* backend = nullptr;
+    };
+
+#endif
@@ -0,0 +1,74 @@
+/*
+    Arduino.h - Host stand-in for the parts of the Arduino core the library uses.
+
+    Only for building the library sources on a PC (see Makefile). Serial writes to stderr
+    and can be silenced; millis() / micros() run off the monotonic clock and wrap like
+    the Teensy counters, unless a simulation sets its own clock with setHostClock().
+    */
+
+    #ifndef bdrcan_host_arduino_h
+    #define bdrcan_host_arduino_h
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <math.h>
+    #include <string>
+
+    #define HEX 16
+    #define DEC 10
+
+    class String {
+    public:
+        String(const char* text = "") : text(text ? text : "") {}
+
+        void replace(char from, char to) {
+            for (size_t i = 0; i < text.size(); i++) {
+                if (text[i] == from) text[i] = to;
+            }
+        }
+        float toFloat() const { return strtof(text.c_str(), nullptr); }
+        const char* c_str() const { return text.c_str(); }
+
+    private:
+        std::string text;
+    };
+
+    class HostSerial {
+    public:
+        void begin(unsigned long) {}
+        operator bool() const { return true; }
+
+        // Diagnostics go to stderr; tools embedding the library can turn them off
+        void setEnabled(bool enabled) { this->enabled = enabled; }
+
+        void print(const char* text) { if (enabled) fputs(text, stderr); }
+        void print(char c) { if (enabled) fputc(c, stderr); }
+        void print(int value, int base = DEC) { print((long)value, base); }
+        void print(unsigned int value, int base = DEC) { print((unsigned long)value, base); }
+        void print(long value, int base = DEC) { if (enabled) fprintf(stderr, base == HEX ? "%lX" : "%ld", value); }
+        void print(unsigned long value, int base = DEC) { if (enabled) fprintf(stderr, base == HEX ? "%lX" : "%lu", value); }
+        void print(double value, int digits = 2) { if (enabled) fprintf(stderr, "%.*f", digits, value); }
+
+        template <typename T> void println(T value) { print(value); println(); }
+        template <typename T> void println(T value, int format) { print(value, format); println(); }
+        void println() { print("\n"); }
+
+    private:
+        bool enabled = true;
+    };
+
+    extern HostSerial Serial;
+
+    uint32_t millis();
+    uint32_t micros();
+    void delay(uint32_t ms);
+
+    // From the first call on, millis() / micros() return this simulated time instead
+    void setHostClock(uint64_t nowUs);
+    long random(long max);
+    long random(long min, long max);
+    void randomSeed(unsigned long seed);
+
+#endif
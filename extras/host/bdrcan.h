@@ -0,0 +1,97 @@
+/*
+    bdrcan.h - C ABI of libbdrcan.so, the host build of the signal table and decoders.
+
+    Plain C types and fixed-layout structs only, so Python (ctypes / cffi), Rust, Go or C#
+    tools can decode whole arrays of frames in one call. Built from the same sources as the
+    car firmware; nothing here allocates.
+    */
+
+    #ifndef bdrcan_c_h
+    #define bdrcan_c_h
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+    #if defined(_WIN32)
+    #define BDRCAN_API __declspec(dllexport)
+    #else
+    #define BDRCAN_API __attribute__((visibility("default")))
+    #endif
+
+    // Bumped on any incompatible change to the functions or structs below
+    #define BDRCAN_ABI_VERSION 1
+
+    #define BDRCAN_DEVICE_INVERTER 0
+    #define BDRCAN_DEVICE_BMS 1
+
+    // 16 bytes, no padding: id, length, 3 reserved bytes, data
+    typedef struct bdrcan_frame {
+        uint32_t id;
+        uint8_t length;
+        uint8_t reserved[3];
+        uint8_t data[8];
+    } bdrcan_frame;
+
+    typedef struct bdrcan_signal_info {
+        const char* name;
+        const char* alt;
+        const char* units;
+        const char* description;
+        uint32_t id;
+        int32_t bit_start;
+        int32_t length;             // bits
+        float min;
+        float max;
+        float scale;
+        int32_t device;             // BDRCAN_DEVICE_*
+        int32_t slot;               // dense ID slot, shared by signals of the same frame
+    } bdrcan_signal_info;
+
+    BDRCAN_API int bdrcan_abi_version(void);
+
+    // Signal metadata; index 0 <= i < bdrcan_signal_count(). Returns 0, or -1 for a bad index.
+    BDRCAN_API int bdrcan_signal_count(void);
+    BDRCAN_API int bdrcan_signal_info_get(int index, bdrcan_signal_info* info);
+
+    // Index of a signal by name, else by alt name, ignoring case; -1 if unknown
+    BDRCAN_API int bdrcan_find_signal(const char* name);
+
+    // ID lookup: slot of an ID (-1 if unknown), and the signals it carries.
+    // bdrcan_id_signals returns the count and writes the index of the first one.
+    BDRCAN_API int bdrcan_slot_count(void);
+    BDRCAN_API int bdrcan_find_slot(uint32_t id);
+    BDRCAN_API int bdrcan_id_signals(uint32_t id, int* first_index);
+
+    // Decode one frame; returns the number of values written (0 for unknown IDs). Fields past a
+    // short frame's DLC are left out: values[i] is signal first_index + i for i < the result.
+    BDRCAN_API int bdrcan_decode_frame(const bdrcan_frame* frame, float* values, int max_values);
+
+    // Decode frames[0..count) into flat value / signal-index arrays of the given capacity.
+    // Decoding stops before a frame that no longer fits. *frames_done receives the number of
+    // frames decoded; offsets (optional, count + 1 entries) receives where each frame's values
+    // start. Returns the number of values written.
+    BDRCAN_API size_t bdrcan_decode_batch(const bdrcan_frame* frames, size_t count,
+                                          float* values, int32_t* signal_indices, size_t capacity,
+                                          uint32_t* offsets, size_t* frames_done);
+
+    // Decode a reassembled OBD2 response payload (the bytes after the 0x62 / PID header) for a
+    // BMS signal, one value per array element, e.g. the 12 cells of cell_voltages_1_12.
+    // Uses SSE2 / AVX2 when the CPU has them. Returns the count, or -1 for a bad index.
+    BDRCAN_API int bdrcan_decode_bms_array(int index, const uint8_t* payload, size_t length,
+                                           float* values, size_t capacity);
+
+    // Encode a physical value into the signal's field of data (merged, other bits kept).
+    // Returns 0, or -1 for a bad index.
+    BDRCAN_API int bdrcan_encode(int index, float value, uint8_t* data);
+
+    // Library diagnostics (out-of-bounds warnings) go to stderr unless disabled
+    BDRCAN_API void bdrcan_set_diagnostics(int enabled);
+
+    #ifdef __cplusplus
+    }
+    #endif
+
+#endif
@@ -0,0 +1,130 @@
+#include "Arduino.h"
+#include "bdrcan.h"
+#include "bdrcanlib.h"
+#include "bdrcansimd.h"
+
+static_assert(sizeof(bdrcan_frame) == 16, "bdrcan_frame layout is part of the ABI");
+
+static BDRCANLib lib;
+
+static inline messageStruct toMessage(const bdrcan_frame& frame) {
+    messageStruct msg;
+    msg.id = frame.id;
+    msg.length = (frame.length > 8) ? 8 : frame.length;
+    memcpy(msg.data, frame.data, 8);
+    return msg;
+}
+
+int bdrcan_abi_version(void) {
+    return BDRCAN_ABI_VERSION;
+}
+
+int bdrcan_signal_count(void) {
+    int count;
+    BDRCANLib::getAllMessages(&count);
+    return count;
+}
+
+int bdrcan_signal_info_get(int index, bdrcan_signal_info* info) {
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    if (index < 0 || index >= count || info == nullptr) return -1;
+
+    const CanMessage& def = *all[index];
+    info->name = def.name;
+    info->alt = def.alt;
+    info->units = def.units;
+    info->description = def.description;
+    info->id = def.id;
+    info->bit_start = def.bit_start;
+    info->length = def.length;
+    info->min = def.min;
+    info->max = def.max;
+    info->scale = def.scale;
+    info->device = BDRCANLib::isBMSMessage(&def) ? BDRCAN_DEVICE_BMS : BDRCAN_DEVICE_INVERTER;
+    info->slot = BDRCANLib::findSlotByID(def.id);
+    return 0;
+}
+
+int bdrcan_find_signal(const char* name) {
+    const CanMessage* msg = BDRCANLib::findMessageByName(name);
+    if (msg == nullptr) msg = BDRCANLib::findMessageByAlt(name);
+    return (msg == nullptr) ? -1 : BDRCANLib::findMessageIndex(msg);
+}
+
+int bdrcan_slot_count(void) {
+    return BDRCANLib::getSlotCount();
+}
+
+int bdrcan_find_slot(uint32_t id) {
+    return BDRCANLib::findSlotByID(id);
+}
+
+int bdrcan_id_signals(uint32_t id, int* first_index) {
+    int count;
+    const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(id), &count);
+    if (first_index != nullptr) {
+        // Slot definitions are a contiguous run of getAllMessages()
+        *first_index = (defs != nullptr) ? (int)(defs - BDRCANLib::getAllMessages()) : -1;
+    }
+    return count;
+}
+
+int bdrcan_decode_frame(const bdrcan_frame* frame, float* values, int max_values) {
+    if (frame == nullptr || values == nullptr) return 0;
+    return lib.decodeFrame(toMessage(*frame), values, max_values);
+}
+
+size_t bdrcan_decode_batch(const bdrcan_frame* frames, size_t count,
+                           float* values, int32_t* signal_indices, size_t capacity,
+                           uint32_t* offsets, size_t* frames_done) {
+    const CanMessage* const* all = BDRCANLib::getAllMessages();
+    size_t written = 0;
+    size_t done = 0;
+
+    if (frames != nullptr && values != nullptr) {
+        for (; done < count; done++) {
+            const bdrcan_frame& frame = frames[done];
+            int slotCount;
+            const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(frame.id), &slotCount);
+            if (written + slotCount > capacity) break;
+
+            if (offsets != nullptr) offsets[done] = (uint32_t)written;
+            int n = lib.decodeFrame(toMessage(frame), &values[written], slotCount);
+            if (signal_indices != nullptr && n > 0) {
+                int first = (int)(defs - all);
+                for (int i = 0; i < n; i++) signal_indices[written + i] = first + i;
+            }
+            written += n;
+        }
+    }
+
+    if (offsets != nullptr) offsets[done] = (uint32_t)written;
+    if (frames_done != nullptr) *frames_done = done;
+    return written;
+}
+
+int bdrcan_decode_bms_array(int index, const uint8_t* payload, size_t length,
+                            float* values, size_t capacity) {
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    if (index < 0 || index >= count || !BDRCANLib::isBMSMessage(all[index])) return -1;
+    return decodeBMSArray(payload, length, *all[index], values, capacity);
+}
+
+int bdrcan_encode(int index, float value, uint8_t* data) {
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    if (index < 0 || index >= count || data == nullptr) return -1;
+
+    if (BDRCANLib::isBMSMessage(all[index])) {
+        BDRCANLib::encodeBMSValue(value, *all[index], data);
+    } else {
+        BDRCANLib::encodeInverterValue(value, *all[index], data);
+    }
+    return 0;
+}
+
+void bdrcan_set_diagnostics(int enabled) {
+    Serial.setEnabled(enabled != 0);
+}
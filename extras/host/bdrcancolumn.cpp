@@ -0,0 +1,368 @@
+#include "bdrcancolumn.h"
+#include <string.h>
+
+static const char COLUMN_MAGIC[8] = {'B', 'D', 'R', 'C', 'O', 'L', 0, 0};
+static const uint32_t COLUMN_VERSION = 1;
+static const size_t HEADER_BYTES = 16;
+static const size_t TRAILER_BYTES = 16;
+
+// Little-endian encoding helpers, independent of host byte order
+
+static void put(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static void putFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put(out, bits, 4);
+}
+
+static void putString(std::vector<uint8_t>& out, const std::string& text) {
+    put(out, text.size(), 2);
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// Bounds-checked reader over a byte buffer; ok turns false on overrun
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    uint64_t get(int bytes) {
+        if (end - p < bytes) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) value |= (uint64_t)p[i] << (8 * i);
+        p += bytes;
+        return value;
+    }
+
+    float getFloat() {
+        uint32_t bits = (uint32_t)get(4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string getString() {
+        size_t n = (size_t)get(2);
+        if ((size_t)(end - p) < n) {
+            ok = false;
+            return std::string();
+        }
+        std::string text((const char*)p, n);
+        p += n;
+        return text;
+    }
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) break;
+            uint8_t byte = *p++;
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+ColumnWriter::~ColumnWriter() {
+    if (file != nullptr) close();
+}
+
+bool ColumnWriter::open(const char* path, uint32_t blockRows) {
+    file = fopen(path, "wb");
+    if (file == nullptr) return false;
+    this->blockRows = blockRows ? blockRows : DEFAULT_BLOCK_ROWS;
+
+    // One column per table entry, metadata straight from the definition
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    columns.assign(count, ColumnInfo());
+    pending.assign(count, Pending());
+    for (int i = 0; i < count; i++) {
+        const CanMessage& def = *all[i];
+        ColumnInfo& column = columns[i];
+        column.index = i;
+        column.id = def.id;
+        column.bitStart = def.bit_start;
+        column.length = def.length;
+        column.scale = def.scale;
+        column.min = def.min;
+        column.max = def.max;
+        column.bms = BDRCANLib::isBMSMessage(&def);
+        column.name = def.name;
+        column.alt = def.alt;
+        column.units = def.units;
+        column.rows = 0;
+    }
+
+    std::vector<uint8_t> header(COLUMN_MAGIC, COLUMN_MAGIC + sizeof(COLUMN_MAGIC));
+    put(header, COLUMN_VERSION, 4);
+    put(header, count, 4);
+    position = fwrite(header.data(), 1, header.size(), file);
+    return position == HEADER_BYTES;
+}
+
+void ColumnWriter::addFrame(uint64_t timestampUs, const messageStruct& msg) {
+    int count;
+    const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(msg.id), &count);
+    if (count == 0) return;
+    int first = (int)(defs - BDRCANLib::getAllMessages());
+
+    for (int i = 0; i < count; i++) {
+        int64_t raw;
+        if (!BDRCANLib::extractRaw(msg, *defs[i], &raw)) continue;
+
+        Pending& column = pending[first + i];
+        column.timestamps.push_back(timestampUs);
+        column.raw.push_back(raw);
+        if (column.timestamps.size() >= blockRows) flush(first + i);
+    }
+}
+
+void ColumnWriter::flush(int index) {
+    Pending& column = pending[index];
+    size_t rows = column.timestamps.size();
+    if (rows == 0 || file == nullptr) return;
+
+    ColumnBlock block;
+    block.offset = position;
+    block.rows = (uint32_t)rows;
+    block.firstUs = column.timestamps.front();
+    block.lastUs = column.timestamps.back();
+    block.minRaw = block.maxRaw = column.raw[0];
+
+    // Timestamps then values, each as zigzag deltas from the previous row
+    scratch.clear();
+    uint64_t previousUs = 0;
+    int64_t previousRaw = 0;
+    for (size_t i = 0; i < rows; i++) {
+        putVarint(scratch, zigzag((int64_t)(column.timestamps[i] - previousUs)));
+        previousUs = column.timestamps[i];
+    }
+    for (size_t i = 0; i < rows; i++) {
+        int64_t raw = column.raw[i];
+        putVarint(scratch, zigzag(raw - previousRaw));
+        previousRaw = raw;
+        if (raw < block.minRaw) block.minRaw = raw;
+        if (raw > block.maxRaw) block.maxRaw = raw;
+    }
+
+    block.bytes = (uint32_t)scratch.size();
+    position += fwrite(scratch.data(), 1, scratch.size(), file);
+    columns[index].blocks.push_back(block);
+    columns[index].rows += rows;
+    column.timestamps.clear();
+    column.raw.clear();
+}
+
+bool ColumnWriter::close() {
+    if (file == nullptr) return false;
+    for (size_t i = 0; i < pending.size(); i++) flush((int)i);
+
+    std::vector<uint8_t> footer;
+    for (const ColumnInfo& column : columns) {
+        put(footer, column.index, 4);
+        put(footer, column.id, 4);
+        put(footer, (uint32_t)column.bitStart, 4);
+        put(footer, (uint32_t)column.length, 4);
+        putFloat(footer, column.scale);
+        putFloat(footer, column.min);
+        putFloat(footer, column.max);
+        put(footer, column.bms ? 1 : 0, 1);
+        putString(footer, column.name);
+        putString(footer, column.alt);
+        putString(footer, column.units);
+        put(footer, column.rows, 8);
+        put(footer, column.blocks.size(), 4);
+        for (const ColumnBlock& block : column.blocks) {
+            put(footer, block.offset, 8);
+            put(footer, block.bytes, 4);
+            put(footer, block.rows, 4);
+            put(footer, block.firstUs, 8);
+            put(footer, block.lastUs, 8);
+            put(footer, (uint64_t)block.minRaw, 8);
+            put(footer, (uint64_t)block.maxRaw, 8);
+        }
+    }
+    put(footer, position, 8);
+    footer.insert(footer.end(), COLUMN_MAGIC, COLUMN_MAGIC + sizeof(COLUMN_MAGIC));
+
+    bool ok = fwrite(footer.data(), 1, footer.size(), file) == footer.size();
+    ok &= fclose(file) == 0;
+    file = nullptr;
+    columns.clear();
+    pending.clear();
+    return ok;
+}
+
+ColumnReader::~ColumnReader() {
+    close();
+}
+
+void ColumnReader::close() {
+    if (file != nullptr) fclose(file);
+    file = nullptr;
+    columns.clear();
+    bytesRead = 0;
+}
+
+bool ColumnReader::open(const char* path) {
+    close();
+    file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    // Trailer: footer offset and magic
+    uint8_t trailer[TRAILER_BYTES];
+    if (fseeko(file, 0, SEEK_END) != 0) return false;
+    off_t size = ftello(file);
+    if (size < (off_t)(HEADER_BYTES + TRAILER_BYTES) || fseeko(file, size - TRAILER_BYTES, SEEK_SET) != 0 ||
+        fread(trailer, 1, TRAILER_BYTES, file) != TRAILER_BYTES ||
+        memcmp(trailer + 8, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0) {
+        close();
+        return false;
+    }
+
+    Cursor trailerCursor = {trailer, trailer + 8, true};
+    uint64_t footerOffset = trailerCursor.get(8);
+    if (footerOffset < HEADER_BYTES || footerOffset > (uint64_t)size - TRAILER_BYTES) {
+        close();
+        return false;
+    }
+
+    uint8_t header[HEADER_BYTES];
+    std::vector<uint8_t> footer(size - TRAILER_BYTES - footerOffset);
+    if (fseeko(file, 0, SEEK_SET) != 0 || fread(header, 1, HEADER_BYTES, file) != HEADER_BYTES ||
+        fseeko(file, footerOffset, SEEK_SET) != 0 || fread(footer.data(), 1, footer.size(), file) != footer.size()) {
+        close();
+        return false;
+    }
+
+    Cursor headerCursor = {header + sizeof(COLUMN_MAGIC), header + HEADER_BYTES, true};
+    uint32_t version = (uint32_t)headerCursor.get(4);
+    uint32_t count = (uint32_t)headerCursor.get(4);
+    if (memcmp(header, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 || version != COLUMN_VERSION) {
+        close();
+        return false;
+    }
+
+    Cursor in = {footer.data(), footer.data() + footer.size(), true};
+    columns.resize(count);
+    for (ColumnInfo& column : columns) {
+        column.index = (uint32_t)in.get(4);
+        column.id = (uint32_t)in.get(4);
+        column.bitStart = (int32_t)in.get(4);
+        column.length = (int32_t)in.get(4);
+        column.scale = in.getFloat();
+        column.min = in.getFloat();
+        column.max = in.getFloat();
+        column.bms = in.get(1) != 0;
+        column.name = in.getString();
+        column.alt = in.getString();
+        column.units = in.getString();
+        column.rows = in.get(8);
+        uint32_t blocks = (uint32_t)in.get(4);
+        if (!in.ok || blocks > footer.size()) break;
+        column.blocks.resize(blocks);
+        for (ColumnBlock& block : column.blocks) {
+            block.offset = in.get(8);
+            block.bytes = (uint32_t)in.get(4);
+            block.rows = (uint32_t)in.get(4);
+            block.firstUs = in.get(8);
+            block.lastUs = in.get(8);
+            block.minRaw = (int64_t)in.get(8);
+            block.maxRaw = (int64_t)in.get(8);
+        }
+    }
+    if (!in.ok) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+int ColumnReader::findColumn(const char* name) const {
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].name == name || columns[i].alt == name) return (int)i;
+    }
+
+    // "0x27": the only signal on that ID
+    char* end;
+    unsigned long id = strtoul(name, &end, 16);
+    if (strncmp(name, "0x", 2) == 0 && *end == '\0') {
+        int found = -1;
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i].id != id) continue;
+            if (found >= 0) return -1;
+            found = (int)i;
+        }
+        return found;
+    }
+    return -1;
+}
+
+bool ColumnReader::read(int index, uint64_t fromUs, uint64_t toUs, std::vector<uint64_t>& timestamps,
+                        std::vector<int64_t>* raw, std::vector<float>* values) {
+    if (file == nullptr || index < 0 || index >= (int)columns.size()) return false;
+    const ColumnInfo& column = columns[index];
+
+    // Decode with the stored metadata, so files stay readable after the table changes
+    CanMessage definition = {};
+    definition.name = column.name.c_str();
+    definition.id = column.id;
+    definition.bit_start = column.bitStart;
+    definition.length = column.length;
+    definition.min = column.min;
+    definition.max = column.max;
+    definition.scale = column.scale;
+
+    for (const ColumnBlock& block : column.blocks) {
+        if (block.lastUs < fromUs || block.firstUs > toUs) continue;
+
+        scratch.resize(block.bytes);
+        if (fseeko(file, block.offset, SEEK_SET) != 0 || fread(scratch.data(), 1, block.bytes, file) != block.bytes) {
+            return false;
+        }
+        bytesRead += block.bytes;
+
+        Cursor in = {scratch.data(), scratch.data() + scratch.size(), true};
+        std::vector<uint64_t> blockTimes(block.rows);
+        uint64_t us = 0;
+        for (uint32_t i = 0; i < block.rows; i++) {
+            us += (uint64_t)unzigzag(in.getVarint());
+            blockTimes[i] = us;
+        }
+        int64_t value = 0;
+        for (uint32_t i = 0; i < block.rows; i++) {
+            value += unzigzag(in.getVarint());
+            if (blockTimes[i] < fromUs || blockTimes[i] > toUs) continue;
+            timestamps.push_back(blockTimes[i]);
+            if (raw != nullptr) raw->push_back(value);
+            if (values != nullptr) values->push_back(BDRCANLib::scaleRaw(value, definition));
+        }
+        if (!in.ok) return false;
+    }
+    return true;
+}
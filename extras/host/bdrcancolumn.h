@@ -0,0 +1,107 @@
+/*
+    bdrcancolumn.h - Columnar .bdrcol files of decoded signals.
+
+    One column per CanMessage in the table, holding (timestamp, raw integer) rows. Columns are
+    cut into blocks of up to blockRows rows, and each block is compressed on its own: zigzag
+    deltas packed as varints. The footer keeps every column's table metadata (scale, units,
+    min / max, bit layout) and, for each block, its offset, row count, time range and raw
+    min / max. A reader can load one channel, or one time window of it, without touching the
+    other columns' blocks.
+
+    Layout: 16-byte header | blocks ... | footer | footer offset (8) | "BDRCOL\0\0"
+    */
+
+    #ifndef bdrcancolumn_h
+    #define bdrcancolumn_h
+    #include <stdint.h>
+    #include <stdio.h>
+    #include <string>
+    #include <vector>
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    struct ColumnBlock {
+        uint64_t offset;            // file offset of the compressed block
+        uint32_t bytes;             // compressed size
+        uint32_t rows;
+        uint64_t firstUs;           // first / last timestamp in the block
+        uint64_t lastUs;
+        int64_t minRaw;             // raw value range in the block
+        int64_t maxRaw;
+    };
+
+    struct ColumnInfo {
+        uint32_t index;             // position in BDRCANLib::getAllMessages()
+        uint32_t id;
+        int32_t bitStart;
+        int32_t length;
+        float scale;
+        float min;
+        float max;
+        bool bms;                   // BMS definitions multiply by scale, inverter ones divide
+        std::string name;
+        std::string alt;
+        std::string units;
+        uint64_t rows;
+        std::vector<ColumnBlock> blocks;
+    };
+
+    class ColumnWriter {
+    public:
+        ~ColumnWriter();
+
+        bool open(const char* path, uint32_t blockRows = DEFAULT_BLOCK_ROWS);
+
+        // Append every signal of a frame to its column; fields past the DLC are skipped
+        void addFrame(uint64_t timestampUs, const messageStruct& msg);
+
+        // Flush the partial blocks and write the footer
+        bool close();
+
+        static const uint32_t DEFAULT_BLOCK_ROWS = 4096;
+
+    private:
+        struct Pending {
+            std::vector<uint64_t> timestamps;
+            std::vector<int64_t> raw;
+        };
+
+        void flush(int column);
+
+        FILE* file = nullptr;
+        uint64_t position = 0;
+        uint32_t blockRows = DEFAULT_BLOCK_ROWS;
+        std::vector<ColumnInfo> columns;
+        std::vector<Pending> pending;
+        std::vector<uint8_t> scratch;
+    };
+
+    class ColumnReader {
+    public:
+        ~ColumnReader();
+
+        bool open(const char* path);
+        void close();
+
+        int columnCount() const { return (int)columns.size(); }
+        const ColumnInfo& column(int i) const { return columns[i]; }
+
+        // Column by signal name or alternative name, then by exact "0xID" with one signal; -1 if none
+        int findColumn(const char* name) const;
+
+        // Rows of one column with fromUs <= timestamp <= toUs. Only blocks overlapping the
+        // range are read. values receives the decoded value (same as decodeFrame).
+        bool read(int column, uint64_t fromUs, uint64_t toUs, std::vector<uint64_t>& timestamps,
+                  std::vector<int64_t>* raw, std::vector<float>* values);
+
+        // Bytes read from blocks since open(), for checking that a query stayed in its column
+        uint64_t blockBytesRead() const { return bytesRead; }
+
+    private:
+        FILE* file = nullptr;
+        std::vector<ColumnInfo> columns;
+        std::vector<uint8_t> scratch;
+        uint64_t bytesRead = 0;
+    };
+
+#endif
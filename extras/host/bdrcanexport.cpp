@@ -0,0 +1,310 @@
+#include "bdrcanexport.h"
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// "00" "01" ... "99": two digits per table read
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const double POWERS_OF_TEN[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+static const int MAX_DECIMALS = 6;
+
+// Digits of value, right-aligned to end; returns the first digit
+static char* writeDigits(uint64_t value, char* end) {
+    while (value >= 100) {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + 2 * value, 2);
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+static std::string csvField(const char* text) {
+    if (strpbrk(text, ",\"\n\r") == nullptr) return text;
+    std::string field = "\"";
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"') field += '"';
+        field += *c;
+    }
+    return field + "\"";
+}
+
+static std::string jsonString(const char* text) {
+    std::string out = "\"";
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if ((unsigned char)*c < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)*c);
+            out += escape;
+        } else {
+            out += *c;
+        }
+    }
+    return out + "\"";
+}
+
+// Fewest decimals that write x exactly, to float precision
+static int decimalsOf(double x) {
+    for (int d = 0; d < MAX_DECIMALS; d++) {
+        double steps = fabs(x) * POWERS_OF_TEN[d];
+        if (fabs(steps - nearbyint(steps)) < 1e-6 * (steps > 1 ? steps : 1)) return d;
+    }
+    return MAX_DECIMALS;
+}
+
+int ExportWriter::signalDecimals(const CanMessage& definition) {
+    // Inverter values are raw / scale, BMS values raw * scale; clamping can also return min / max
+    double resolution = BDRCANLib::isBMSMessage(&definition) ? definition.scale : 1.0 / definition.scale;
+    int decimals = decimalsOf(resolution);
+    if (decimalsOf(definition.min) > decimals) decimals = decimalsOf(definition.min);
+    if (decimalsOf(definition.max) > decimals) decimals = decimalsOf(definition.max);
+    return decimals;
+}
+
+int ExportWriter::formatValue(float value, int decimals, char* out, bool json) {
+    if (!isfinite(value)) {
+        if (!json) return 0;
+        memcpy(out, "null", 4);
+        return 4;
+    }
+
+    double scaled = fabs((double)value) * POWERS_OF_TEN[decimals];
+    if (scaled >= 9e15) return snprintf(out, 32, "%.9g", (double)value);
+
+    // Rounding at the signal's resolution recovers the exact decimal the raw value stands for
+    uint64_t units = (uint64_t)llround(scaled);
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* first = writeDigits(units, end);
+    int length = (int)(end - first);
+
+    // At least one digit before the point: 5 with 2 decimals is 0.05
+    while (length <= decimals) {
+        *--first = '0';
+        length++;
+    }
+
+    char* p = out;
+    if (value < 0 && units != 0) *p++ = '-';
+    int whole = length - decimals;
+    memcpy(p, first, whole);
+    p += whole;
+    if (decimals > 0) {
+        *p++ = '.';
+        memcpy(p, first + whole, decimals);
+        p += decimals;
+    }
+    return (int)(p - out);
+}
+
+ExportWriter::ExportWriter(ExportFormat format, size_t bufferBytes) : format(format), buffer(bufferBytes) {
+    memset(&stats, 0, sizeof(stats));
+
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    decimals.resize(count);
+    csvPrefix.resize(count);
+    jsonKey.resize(count);
+    for (int i = 0; i < count; i++) {
+        decimals[i] = (int8_t)signalDecimals(*all[i]);
+        csvPrefix[i] = csvField(all[i]->name) + "," + csvField(all[i]->units) + ",";
+        jsonKey[i] = jsonString(all[i]->name) + ":";
+        size_t prefix = (format == EXPORT_CSV) ? csvPrefix[i].size() : jsonKey[i].size();
+        if (prefix + 32 > maxSignalBytes) maxSignalBytes = prefix + 32;
+    }
+
+    size_t frameBytes = 64 + BDRCANLib::MAX_SIGNALS_PER_ID * (maxSignalBytes + 32);
+    if (buffer.size() < frameBytes) buffer.resize(frameBytes);
+
+    std::vector<int> every(count);
+    for (int i = 0; i < count; i++) every[i] = i;
+    setColumns(every);
+}
+
+ExportWriter::~ExportWriter() {
+    close();
+}
+
+bool ExportWriter::open(const char* path) {
+    close();
+    if (path == nullptr || strcmp(path, "-") == 0) {
+        fd = STDOUT_FILENO;
+        ownsFd = false;
+    } else {
+        fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Error: cannot write %s: %s\n", path, strerror(errno));
+            return false;
+        }
+        ownsFd = true;
+    }
+    failed = false;
+    used = 0;
+    return true;
+}
+
+bool ExportWriter::close() {
+    if (fd < 0) return !failed;
+    bool ok = flush();
+    if (ownsFd && ::close(fd) != 0) ok = false;
+    fd = -1;
+    return ok;
+}
+
+void ExportWriter::setColumns(const std::vector<int>& indices) {
+    columns = indices;
+    maxSnapshotBytes = 64;
+    for (int index : columns) {
+        maxSnapshotBytes += (format == EXPORT_CSV) ? 33 : jsonKey[index].size() + 33;
+    }
+    // A snapshot row has to fit the buffer whole
+    if (maxSnapshotBytes > buffer.size()) buffer.resize(maxSnapshotBytes);
+}
+
+void ExportWriter::append(const char* text, size_t length) {
+    memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+void ExportWriter::appendUnsigned(uint64_t value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* first = writeDigits(value, end);
+    append(first, end - first);
+}
+
+void ExportWriter::writeFrameHeader() {
+    if (format != EXPORT_CSV) return;
+    static const char HEADER[] = "timestamp_us,id,signal,units,value\n";
+    reserve(sizeof(HEADER));
+    append(HEADER, sizeof(HEADER) - 1);
+}
+
+void ExportWriter::writeSnapshotHeader() {
+    if (format != EXPORT_CSV) return;
+    const CanMessage* const* all = BDRCANLib::getAllMessages();
+    std::string header = "timestamp_us";
+    for (int index : columns) {
+        std::string title = all[index]->name;
+        if (all[index]->units[0] != '\0') title = title + " " + all[index]->units;
+        header += "," + csvField(title.c_str());
+    }
+    header += "\n";
+    if (used + header.size() > buffer.size()) flush();
+    if (header.size() > buffer.size()) buffer.resize(header.size());
+    append(header.data(), header.size());
+}
+
+void ExportWriter::writeFrame(uint64_t timestampUs, uint32_t id, const CanMessage* const* definitions,
+                              const float* values, int count) {
+    if (count <= 0) return;
+    reserve(64 + count * (maxSignalBytes + 32));
+
+    if (format == EXPORT_CSV) {
+        // The row head is the same for every value of the frame
+        char head[48];
+        char* end = head + sizeof(head);
+        char* p = end;
+        // Hex ID, as bdrcan-decode prints it
+        *--p = ',';
+        uint32_t rest = id;
+        do {
+            *--p = "0123456789ABCDEF"[rest & 0xF];
+            rest >>= 4;
+        } while (rest != 0);
+        *--p = 'x';
+        *--p = '0';
+        *--p = ',';
+        char* stamp = writeDigits(timestampUs, p);
+        size_t headLength = end - stamp;
+
+        for (int i = 0; i < count; i++) {
+            int index = BDRCANLib::findMessageIndex(definitions[i]);
+            append(stamp, headLength);
+            const std::string& prefix = csvPrefix[index];
+            append(prefix.data(), prefix.size());
+            used += formatValue(values[i], decimals[index], buffer.data() + used);
+            buffer[used++] = '\n';
+        }
+        stats.rows += count;
+    } else {
+        append("{\"timestamp_us\":", 16);
+        appendUnsigned(timestampUs);
+        append(",\"id\":", 6);
+        appendUnsigned(id);
+        for (int i = 0; i < count; i++) {
+            int index = BDRCANLib::findMessageIndex(definitions[i]);
+            buffer[used++] = ',';
+            const std::string& key = jsonKey[index];
+            append(key.data(), key.size());
+            used += formatValue(values[i], decimals[index], buffer.data() + used, true);
+        }
+        append("}\n", 2);
+        stats.rows++;
+    }
+    stats.values += count;
+}
+
+void ExportWriter::writeSnapshot(uint64_t timestampUs, const float* values, const bool* present) {
+    reserve(maxSnapshotBytes);
+
+    bool json = format == EXPORT_NDJSON;
+    if (json) append("{\"timestamp_us\":", 16);
+    appendUnsigned(timestampUs);
+    for (int index : columns) {
+        buffer[used++] = ',';
+        if (json) append(jsonKey[index].data(), jsonKey[index].size());
+        if (present == nullptr || present[index]) {
+            used += formatValue(values[index], decimals[index], buffer.data() + used, json);
+            stats.values++;
+        } else if (json) {
+            append("null", 4);
+        }
+    }
+    if (json) buffer[used++] = '}';
+    buffer[used++] = '\n';
+    stats.rows++;
+}
+
+bool ExportWriter::flush() {
+    if (fd < 0 || failed) {
+        // Not open: count the bytes and drop them, which measures formatting alone
+        if (!failed) stats.bytes += used;
+        used = 0;
+        return !failed;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0;
+    while (done < used) {
+        ssize_t n = ::write(fd, buffer.data() + done, used - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: export write: %s\n", strerror(errno));
+            failed = true;
+            break;
+        }
+        done += n;
+        stats.writes++;
+    }
+    stats.bytes += done;
+    stats.writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    used = 0;
+    return !failed;
+}
@@ -0,0 +1,107 @@
+/*
+    bdrcanexport.h - Streaming CSV / NDJSON export of decoded signals.
+
+    Rows are formatted straight into one large buffer that is allocated once and handed to
+    the output with a single write() whenever it is nearly full, so nothing is allocated per
+    row and the output sees a few large writes instead of one per value. Values are printed
+    with the decimals of the signal's resolution (0.1 A -> "12.3"), which is exact for every
+    value the decoders return and much cheaper than printf's %g.
+
+    Two row shapes:
+      frames      one CSV row per decoded value (timestamp_us,id,signal,units,value), or one
+                  NDJSON object per frame ({"timestamp_us":..,"id":..,"<name>":<value>,...})
+      snapshots   one row per snapshot with a column per selected signal; CSV headers are
+                  "<name> <units>", and signals not seen yet are empty (CSV) or null (NDJSON)
+    */
+
+    #ifndef bdrcanexport_h
+    #define bdrcanexport_h
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <string>
+    #include <vector>
+    #include "bdrcanlib.h"
+
+    enum ExportFormat {
+        EXPORT_CSV,
+        EXPORT_NDJSON
+    };
+
+    struct ExportStats {
+        uint64_t rows;              // CSV lines / NDJSON objects
+        uint64_t values;            // values formatted
+        uint64_t bytes;             // bytes written
+        uint64_t writes;            // write() calls
+        double writeSeconds;        // time spent in write()
+    };
+
+    class ExportWriter {
+    public:
+        explicit ExportWriter(ExportFormat format, size_t bufferBytes = DEFAULT_BUFFER);
+        ~ExportWriter();
+
+        // Write to a new file, or to stdout for nullptr / "-"; errors go to stderr
+        bool open(const char* path);
+        bool close();
+
+        // Snapshot columns as getAllMessages() indices; every signal until this is called
+        void setColumns(const std::vector<int>& indices);
+
+        // CSV header line for the row shape; nothing for NDJSON
+        void writeFrameHeader();
+        void writeSnapshotHeader();
+
+        // values[i] belongs to definitions[i], as decodeFrame returns them
+        void writeFrame(uint64_t timestampUs, uint32_t id, const CanMessage* const* definitions,
+                        const float* values, int count);
+
+        // values and present are indexed like getAllMessages(); present == nullptr means all
+        void writeSnapshot(uint64_t timestampUs, const float* values, const bool* present);
+
+        // Hand the buffer to the output; false after a write error. Before open() the rows are
+        // counted and dropped, to time the formatting alone.
+        bool flush();
+
+        const ExportStats& getStats() const { return stats; }
+
+        // Decimals that represent every value of the signal exactly (up to 6)
+        static int signalDecimals(const CanMessage& definition);
+
+        // value with that many decimals; NaN / infinity give "" (or "null" when json).
+        // out needs 32 bytes. Returns the length written.
+        static int formatValue(float value, int decimals, char* out, bool json = false);
+
+        static const size_t DEFAULT_BUFFER = 4 << 20;
+
+    private:
+        ExportWriter(const ExportWriter&) = delete;
+        ExportWriter& operator=(const ExportWriter&) = delete;
+
+        // Make room for a row of up to bytes
+        void reserve(size_t bytes) {
+            if (used + bytes > buffer.size()) flush();
+        }
+        void append(const char* text, size_t length);
+        void appendUnsigned(uint64_t value);
+
+        ExportFormat format;
+        int fd = -1;
+        bool ownsFd = false;
+        bool failed = false;
+
+        std::vector<char> buffer;
+        size_t used = 0;
+
+        // Per signal, formatted once: decimals, CSV "name,units," / JSON "\"name\":" prefixes
+        std::vector<int8_t> decimals;
+        std::vector<std::string> csvPrefix;
+        std::vector<std::string> jsonKey;
+        size_t maxSignalBytes = 0;      // longest formatted value with its prefix
+
+        std::vector<int> columns;
+        size_t maxSnapshotBytes = 0;
+
+        ExportStats stats;
+    };
+
+#endif
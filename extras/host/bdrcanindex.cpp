@@ -0,0 +1,201 @@
+#include "Arduino.h"
+#include "bdrcanindex.h"
+#include <algorithm>
+#include <string.h>
+
+static_assert(sizeof(IndexBlock) == 32 + 8 * INDEX_ID_WORDS, "IndexBlock is written to disk as is");
+
+// Written in host byte order (little-endian on every supported host)
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordsPerBlock;
+    uint64_t logSize;
+    uint64_t blockCount;
+    uint64_t tableHash;         // LogIndex::tableHash() of the tool that built it
+};
+
+static const char INDEX_MAGIC[8] = {'B', 'D', 'R', 'I', 'D', 'X', 0, 0};
+static const uint32_t INDEX_VERSION = 2;
+
+// Ranges wider than this mark every bucket instead of walking each ID
+static const uint32_t MAX_RANGE_WALK = 4096;
+
+static bool writeIndex(const char* path, const std::vector<IndexBlock>& blocks, uint32_t recordsPerBlock,
+                       uint64_t logSize) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return false;
+
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.recordsPerBlock = recordsPerBlock;
+    header.logSize = logSize;
+    header.blockCount = blocks.size();
+    header.tableHash = LogIndex::tableHash();
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (!blocks.empty()) ok &= fwrite(blocks.data(), sizeof(IndexBlock), blocks.size(), file) == blocks.size();
+    ok &= fclose(file) == 0;
+    return ok;
+}
+
+uint64_t LogIndex::tableHash() {
+    // FNV-1a over the bitmap width and the ID of every slot, in slot order
+    uint64_t h = 14695981039346656037ULL;
+    uint32_t words[] = {(uint32_t)BDRCANLib::getSlotCount(), (uint32_t)UNKNOWN_ID_BUCKETS};
+    for (uint32_t word : words) {
+        for (int i = 0; i < 4; i++) h = (h ^ ((word >> (8 * i)) & 0xFF)) * 1099511628211ULL;
+    }
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        uint32_t id = BDRCANLib::getSlotMessages(slot)[0]->id;
+        for (int i = 0; i < 4; i++) h = (h ^ ((id >> (8 * i)) & 0xFF)) * 1099511628211ULL;
+    }
+    return h;
+}
+
+int LogIndex::idBit(uint32_t id) {
+    int slot = BDRCANLib::findSlotByID(id);
+    if (slot >= 0) return slot;
+    return BDRCANLib::ID_SLOT_COUNT + (int)(id % UNKNOWN_ID_BUCKETS);
+}
+
+void IdFilter::addRange(uint32_t first, uint32_t last) {
+    if (last < first) std::swap(first, last);
+    ranges.push_back(std::make_pair(first, last));
+
+    if (last - first >= MAX_RANGE_WALK) {
+        for (uint64_t& word : mask) word = ~0ULL;
+        return;
+    }
+    for (uint32_t id = first;; id++) {
+        int bit = LogIndex::idBit(id);
+        mask[bit / 64] |= 1ULL << (bit % 64);
+        if (id == last) break;
+    }
+}
+
+bool IdFilter::matches(uint32_t id) const {
+    if (ranges.empty()) return true;
+    for (const auto& range : ranges) {
+        if (id >= range.first && id <= range.second) return true;
+    }
+    return false;
+}
+
+bool IdFilter::mayContain(const IndexBlock& block) const {
+    if (ranges.empty()) return true;
+    for (int i = 0; i < INDEX_ID_WORDS; i++) {
+        if ((block.ids[i] & mask[i]) != 0) return true;
+    }
+    return false;
+}
+
+LogIndexBuilder::LogIndexBuilder(uint32_t recordsPerBlock)
+    : recordsPerBlock(recordsPerBlock ? recordsPerBlock : DEFAULT_RECORDS_PER_BLOCK) {}
+
+void LogIndexBuilder::add(uint64_t offset, const LogRecord& record) {
+    if (blocks.empty() || blocks.back().records >= recordsPerBlock) {
+        IndexBlock block;
+        memset(&block, 0, sizeof(block));
+        block.offset = offset;
+        block.firstUs = record.timestampUs;
+        block.lastUs = record.timestampUs;
+        blocks.push_back(block);
+    }
+
+    IndexBlock& block = blocks.back();
+    if (record.timestampUs < block.firstUs) block.firstUs = record.timestampUs;
+    if (record.timestampUs > block.lastUs) block.lastUs = record.timestampUs;
+    block.records++;
+
+    int bit = LogIndex::idBit(record.id);
+    block.ids[bit / 64] |= 1ULL << (bit % 64);
+}
+
+bool LogIndexBuilder::write(const char* path, uint64_t logSize) const {
+    return writeIndex(path, blocks, recordsPerBlock, logSize);
+}
+
+bool LogIndex::open(const char* path, uint64_t logSize) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    IndexHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+              header.version == INDEX_VERSION && header.logSize == logSize &&
+              header.tableHash == tableHash();
+    if (ok) {
+        blocks.resize(header.blockCount);
+        if (!blocks.empty()) ok = fread(blocks.data(), sizeof(IndexBlock), blocks.size(), file) == blocks.size();
+    }
+    fclose(file);
+
+    if (!ok) {
+        blocks.clear();
+        return false;
+    }
+    recordsPerBlock = header.recordsPerBlock;
+    endOffset = logSize;
+    finish();
+    return true;
+}
+
+void LogIndex::build(const LogFile& log, uint32_t recordsPerBlock) {
+    LogIndexBuilder builder(recordsPerBlock);
+    LogChunk all = {log.dataStart(), log.size()};
+    size_t cursor = all.begin;
+    size_t start = cursor;
+    LogRecord record;
+
+    // The cursor before next() is where the record starts (or a skipped malformed line before it)
+    while (log.next(all, cursor, record)) {
+        builder.add(start, record);
+        start = cursor;
+    }
+
+    blocks = builder.getBlocks();
+    this->recordsPerBlock = builder.getRecordsPerBlock();
+    endOffset = log.size();
+    finish();
+}
+
+bool LogIndex::save(const char* path, uint64_t logSize) const {
+    return writeIndex(path, blocks, recordsPerBlock, logSize);
+}
+
+void LogIndex::finish() {
+    // Logs are nearly in time order; the running max keeps the binary search valid when they are not
+    lastUsPrefixMax.resize(blocks.size());
+    uint64_t highest = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i].lastUs > highest) highest = blocks[i].lastUs;
+        lastUsPrefixMax[i] = highest;
+    }
+}
+
+uint64_t LogIndex::seek(uint64_t timestampUs) const {
+    // First block that can hold a record at or after timestampUs; everything before it is earlier
+    auto it = std::lower_bound(lastUsPrefixMax.begin(), lastUsPrefixMax.end(), timestampUs);
+    if (it == lastUsPrefixMax.end()) return endOffset;
+    return blocks[it - lastUsPrefixMax.begin()].offset;
+}
+
+std::vector<LogChunk> LogIndex::select(const IdFilter& ids, uint64_t fromUs, uint64_t toUs) const {
+    std::vector<LogChunk> chunks;
+    size_t first = std::lower_bound(lastUsPrefixMax.begin(), lastUsPrefixMax.end(), fromUs) - lastUsPrefixMax.begin();
+
+    for (size_t i = first; i < blocks.size(); i++) {
+        const IndexBlock& block = blocks[i];
+        if (block.lastUs < fromUs || block.firstUs > toUs || !ids.mayContain(block)) continue;
+
+        uint64_t end = (i + 1 < blocks.size()) ? blocks[i + 1].offset : endOffset;
+        if (!chunks.empty() && chunks.back().end == block.offset) {
+            chunks.back().end = end;
+        } else {
+            chunks.push_back({(size_t)block.offset, (size_t)end});
+        }
+    }
+    return chunks;
+}
@@ -0,0 +1,109 @@
+/*
+    bdrcanindex.h - Sidecar index (.idx) for random access into recorded logs.
+
+    The log is cut into blocks of recordsPerBlock records. Each block stores its byte offset,
+    its timestamp range and a map of the IDs it contains: one bit per ID slot of the table,
+    plus hashed buckets for IDs the table does not know. Slots depend on the build profile, so
+    the header records a hash of the slot IDs and an index from another table counts as stale. Seeking to a time is a binary
+    search over the blocks; an ID + time query scans only the blocks whose bitmap and range
+    can match.
+
+    The index can be fed record by record while a log is written (LogIndexBuilder), or built
+    in one pass over an existing log.
+    */
+
+    #ifndef bdrcanindex_h
+    #define bdrcanindex_h
+    #include <stdint.h>
+    #include <utility>
+    #include <vector>
+    #include "bdrcanlib.h"
+    #include "bdrcanlog.h"
+
+    // Bitmap buckets shared by every ID the table does not know
+    static const int INDEX_UNKNOWN_ID_BUCKETS = 10;
+    static const int INDEX_ID_WORDS = (BDRCANLib::ID_SLOT_COUNT + INDEX_UNKNOWN_ID_BUCKETS + 63) / 64;
+
+    struct IndexBlock {
+        uint64_t offset;            // byte offset of the block's first record in the log
+        uint64_t firstUs;           // lowest / highest timestamp in the block
+        uint64_t lastUs;
+        uint32_t records;
+        uint32_t reserved;
+        uint64_t ids[INDEX_ID_WORDS];   // bit per ID key, see LogIndex::idBit()
+    };
+
+    // Set of IDs to select; exact membership plus the bitmap used to skip blocks
+    class IdFilter {
+    public:
+        void add(uint32_t id) { addRange(id, id); }
+        void addRange(uint32_t first, uint32_t last);
+
+        bool empty() const { return ranges.empty(); }
+        bool matches(uint32_t id) const;
+        bool mayContain(const IndexBlock& block) const;
+
+    private:
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+        uint64_t mask[INDEX_ID_WORDS] = {};
+    };
+
+    class LogIndexBuilder {
+    public:
+        explicit LogIndexBuilder(uint32_t recordsPerBlock = DEFAULT_RECORDS_PER_BLOCK);
+
+        // Call for every record in file order with the offset it starts at
+        void add(uint64_t offset, const LogRecord& record);
+
+        // Write the index for a log of logSize bytes
+        bool write(const char* path, uint64_t logSize) const;
+
+        const std::vector<IndexBlock>& getBlocks() const { return blocks; }
+        uint32_t getRecordsPerBlock() const { return recordsPerBlock; }
+
+        static const uint32_t DEFAULT_RECORDS_PER_BLOCK = 1024;
+
+    private:
+        std::vector<IndexBlock> blocks;
+        uint32_t recordsPerBlock;
+    };
+
+    class LogIndex {
+    public:
+        // Load an index; fails if it was built for a log of a different size or another table
+        bool open(const char* path, uint64_t logSize);
+
+        // Build in one pass over an open log
+        void build(const LogFile& log, uint32_t recordsPerBlock = LogIndexBuilder::DEFAULT_RECORDS_PER_BLOCK);
+
+        // Write the index (after build)
+        bool save(const char* path, uint64_t logSize) const;
+
+        // Offset to start reading from to see every record at or after timestampUs
+        uint64_t seek(uint64_t timestampUs) const;
+
+        // Byte ranges of the log that can hold records matching ids (all IDs if empty)
+        // within [fromUs, toUs]; adjacent blocks are merged into one chunk
+        std::vector<LogChunk> select(const IdFilter& ids, uint64_t fromUs, uint64_t toUs) const;
+
+        size_t blockCount() const { return blocks.size(); }
+        const IndexBlock& block(size_t i) const { return blocks[i]; }
+
+        // Bitmap position of an ID: its table slot, or a bucket above the slots for unknown IDs
+        static int idBit(uint32_t id);
+
+        // Hash of the ID slot layout idBit() uses, stored in the header
+        static uint64_t tableHash();
+
+        static const int UNKNOWN_ID_BUCKETS = INDEX_UNKNOWN_ID_BUCKETS;
+
+    private:
+        void finish();
+
+        std::vector<IndexBlock> blocks;
+        std::vector<uint64_t> lastUsPrefixMax;  // running max of lastUs, for binary search
+        uint64_t endOffset = 0;
+        uint32_t recordsPerBlock = LogIndexBuilder::DEFAULT_RECORDS_PER_BLOCK;
+    };
+
+#endif
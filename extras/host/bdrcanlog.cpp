@@ -0,0 +1,183 @@
+#include "bdrcanlog.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char LOG_MAGIC[8] = {'B', 'D', 'R', 'L', 'O', 'G', 0, 0};
+
+void initLogHeader(LogHeader& header) {
+    memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    header.version = LOG_VERSION;
+    header.recordSize = sizeof(LogRecord);
+}
+
+LogFile::~LogFile() {
+    close();
+}
+
+bool LogFile::open(const char* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    base = (const uint8_t*)mapped;
+    length = info.st_size;
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    // Binary logs carry a header; anything else is treated as candump text
+    const LogHeader* header = (const LogHeader*)base;
+    if (length >= sizeof(LogHeader) && memcmp(header->magic, LOG_MAGIC, sizeof(LOG_MAGIC)) == 0) {
+        if (header->version != LOG_VERSION || header->recordSize != sizeof(LogRecord)) {
+            close();
+            return false;
+        }
+        logFormat = LOG_BINARY;
+    } else {
+        logFormat = LOG_CANDUMP;
+    }
+    return true;
+}
+
+void LogFile::close() {
+    if (base != nullptr) munmap((void*)base, length);
+    base = nullptr;
+    length = 0;
+    logFormat = LOG_UNKNOWN;
+}
+
+std::vector<LogChunk> LogFile::split(size_t chunkBytes) const {
+    std::vector<LogChunk> chunks;
+    size_t begin = dataStart();
+    if (chunkBytes == 0) chunkBytes = 1;
+
+    if (logFormat == LOG_BINARY) {
+        // Whole records only; a truncated trailing record is dropped
+        size_t records = (length - begin) / sizeof(LogRecord);
+        size_t perChunk = (chunkBytes + sizeof(LogRecord) - 1) / sizeof(LogRecord);
+        for (size_t first = 0; first < records; first += perChunk) {
+            size_t last = (first + perChunk < records) ? first + perChunk : records;
+            chunks.push_back({begin + first * sizeof(LogRecord), begin + last * sizeof(LogRecord)});
+        }
+        return chunks;
+    }
+
+    // Text: extend each chunk to the end of the line it stops in
+    while (begin < length) {
+        size_t end = begin + chunkBytes;
+        if (end >= length) {
+            end = length;
+        } else {
+            const void* newline = memchr(base + end, '\n', length - end);
+            end = newline ? (const uint8_t*)newline - base + 1 : length;
+        }
+        chunks.push_back({begin, end});
+        begin = end;
+    }
+    return chunks;
+}
+
+bool LogFile::next(const LogChunk& chunk, size_t& cursor, LogRecord& record) const {
+    if (logFormat == LOG_BINARY) {
+        if (cursor + sizeof(LogRecord) > chunk.end) return false;
+        memcpy(&record, base + cursor, sizeof(LogRecord));
+        cursor += sizeof(LogRecord);
+        return true;
+    }
+
+    while (cursor < chunk.end) {
+        const char* line = (const char*)base + cursor;
+        const void* newline = memchr(line, '\n', chunk.end - cursor);
+        size_t lineLength = newline ? (const char*)newline - line : chunk.end - cursor;
+        cursor += lineLength + (newline ? 1 : 0);
+        if (parseCandumpLine(line, lineLength, record)) return true;
+    }
+    return false;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool parseCandumpLine(const char* line, size_t length, LogRecord& record) {
+    const char* p = line;
+    const char* end = line + length;
+    memset(&record, 0, sizeof(record));
+
+    // "(seconds.fraction)", parsed as integers so timestamps round-trip exactly
+    if (p >= end || *p != '(') return false;
+    p++;
+    uint64_t seconds = 0;
+    while (p < end && *p >= '0' && *p <= '9') seconds = seconds * 10 + (*p++ - '0');
+    uint64_t micros = 0;
+    int digits = 0;
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (digits < 6) {
+                micros = micros * 10 + (*p - '0');
+                digits++;
+            }
+        }
+    }
+    for (; digits < 6; digits++) micros *= 10;
+    if (p >= end || *p != ')') return false;
+    p++;
+    record.timestampUs = seconds * 1000000ULL + micros;
+
+    // Interface name; trailing digits become the channel number
+    while (p < end && *p == ' ') p++;
+    uint8_t channel = 0;
+    while (p < end && *p != ' ') {
+        channel = (*p >= '0' && *p <= '9') ? channel * 10 + (*p - '0') : 0;
+        p++;
+    }
+    record.channel = channel;
+    while (p < end && *p == ' ') p++;
+
+    // "ID#DATA": 3 hex digits for standard, 8 for extended IDs
+    const char* idStart = p;
+    uint32_t id = 0;
+    int digit;
+    while (p < end && (digit = hexDigit(*p)) >= 0) {
+        id = (id << 4) | digit;
+        p++;
+    }
+    if (p >= end || *p != '#' || p == idStart) return false;
+    if (p - idStart > 3) record.flags |= LOG_FLAG_EXTENDED;
+    record.id = id;
+    p++;
+
+    // Remote frames ("R") and CAN FD frames ("##") carry no classic payload
+    if (p < end && (*p == 'R' || *p == '#')) return false;
+
+    uint8_t count = 0;
+    while (p + 1 < end && count < 8) {
+        if (*p == '.') {
+            p++;
+            continue;
+        }
+        int high = hexDigit(p[0]);
+        int low = hexDigit(p[1]);
+        if (high < 0 || low < 0) break;
+        record.data[count++] = (uint8_t)((high << 4) | low);
+        p += 2;
+    }
+    record.length = count;
+    return true;
+}
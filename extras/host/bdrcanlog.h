@@ -0,0 +1,79 @@
+/*
+    bdrcanlog.h - Log readers for the host tools: binary .bdrlog files and candump text.
+
+    A log is mapped read-only and split into chunks that always end on a record boundary,
+    so chunks can be parsed independently and their output concatenated in order.
+    */
+
+    #ifndef bdrcanlog_h
+    #define bdrcanlog_h
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <vector>
+
+    // Binary log: 16-byte header, then fixed 24-byte records in receive order
+    struct LogHeader {
+        char magic[8];              // "BDRLOG\0\0"
+        uint32_t version;           // LOG_VERSION
+        uint32_t recordSize;        // sizeof(LogRecord)
+    };
+
+    struct LogRecord {
+        uint64_t timestampUs;       // receive time, microseconds
+        uint32_t id;
+        uint8_t length;
+        uint8_t flags;              // LOG_FLAG_*
+        uint8_t channel;            // bus the frame came from
+        uint8_t reserved;
+        uint8_t data[8];
+    };
+
+    static const uint32_t LOG_VERSION = 1;
+    static const uint8_t LOG_FLAG_EXTENDED = 0x01;
+
+    enum LogFormat {
+        LOG_UNKNOWN,
+        LOG_BINARY,
+        LOG_CANDUMP                 // candump -l style: "(1697712345.123456) can0 123#DEADBEEF"
+    };
+
+    struct LogChunk {
+        size_t begin;               // byte offsets into the mapped file
+        size_t end;
+    };
+
+    class LogFile {
+    public:
+        LogFile() {}
+        ~LogFile();
+
+        bool open(const char* path);
+        void close();
+
+        LogFormat format() const { return logFormat; }
+        const uint8_t* bytes() const { return base; }
+        size_t size() const { return length; }
+
+        // Offset of the first record (past the binary header)
+        size_t dataStart() const { return (logFormat == LOG_BINARY) ? sizeof(LogHeader) : 0; }
+
+        // Split [dataStart, size) into chunks of about chunkBytes ending on record boundaries
+        std::vector<LogChunk> split(size_t chunkBytes) const;
+
+        // Parse the records of one chunk; returns false when the chunk is exhausted.
+        // cursor starts at chunk.begin. Malformed candump lines are skipped.
+        bool next(const LogChunk& chunk, size_t& cursor, LogRecord& record) const;
+
+    private:
+        const uint8_t* base = nullptr;
+        size_t length = 0;
+        LogFormat logFormat = LOG_UNKNOWN;
+    };
+
+    // Parse one candump line (without the newline); returns false if it is not a CAN frame
+    bool parseCandumpLine(const char* line, size_t length, LogRecord& record);
+
+    // Write a binary log header
+    void initLogHeader(LogHeader& header);
+
+#endif
@@ -0,0 +1,273 @@
+#include "bdrcanshm.h"
+#include "bdrcansignal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SNAPSHOT_MAGIC[8] = {'B', 'D', 'R', 'S', 'H', 'M', 0, 0};
+
+// Cell array PIDs take one value per element of a reassembled response; the ID list comes
+// from the layout table, so it is there in every profile
+static const int ARRAY_ELEMENTS = sizeof(OBD2Response::values) / sizeof(OBD2Response::values[0]);
+
+#define BDRCAN_LAYOUT_ID(name, id, bit_start, length, min, max, scale) id,
+static const uint32_t ARRAY_IDS[] = { BDRCAN_BMS_CELL_LAYOUTS(BDRCAN_LAYOUT_ID) };
+#undef BDRCAN_LAYOUT_ID
+
+static int signalElements(const CanMessage& definition) {
+    for (uint32_t id : ARRAY_IDS) {
+        if (definition.id == id) return ARRAY_ELEMENTS;
+    }
+    return 1;
+}
+
+static uint64_t hashBytes(uint64_t h, const void* bytes, size_t length) {
+    const uint8_t* p = (const uint8_t*)bytes;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ p[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t snapshotTableHash() {
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < count; i++) {
+        const CanMessage& m = *all[i];
+        h = hashBytes(h, m.name, strlen(m.name) + 1);
+        int32_t layout[3] = {(int32_t)m.id, m.bit_start, m.length};
+        float limits[3] = {m.min, m.max, m.scale};
+        h = hashBytes(h, layout, sizeof(layout));
+        h = hashBytes(h, limits, sizeof(limits));
+    }
+    return h;
+}
+
+SnapshotPublisher::~SnapshotPublisher() {
+    close();
+}
+
+bool SnapshotPublisher::open(const char* name) {
+    close();
+
+    int count;
+    const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+    uint32_t valueCount = 0;
+    for (int i = 0; i < count; i++) valueCount += signalElements(*all[i]);
+    size_t bytes = sizeof(SnapshotHeader) + count * sizeof(SnapshotSignal) + valueCount * sizeof(SnapshotValue);
+
+    // A new segment every time: readers of an old one keep a valid mapping and see live == 0
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: shared memory %s: %s\n", name, strerror(errno));
+        return false;
+    }
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)bytes) == 0) {
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Error: shared memory %s: %s\n", name, strerror(error));
+        shm_unlink(name);
+        return false;
+    }
+
+    // The segment starts zeroed; the atomics are constructed in place before the magic is set
+    header = new (base) SnapshotHeader();
+    signals = (SnapshotSignal*)(header + 1);
+    values = new ((void*)(signals + count)) SnapshotValue[valueCount]();
+    size = bytes;
+
+    uint32_t firstValue = 0;
+    for (int i = 0; i < count; i++) {
+        const CanMessage& m = *all[i];
+        SnapshotSignal& s = signals[i];
+        snprintf(s.name, sizeof(s.name), "%s", m.name);
+        snprintf(s.alt, sizeof(s.alt), "%s", m.alt);
+        snprintf(s.units, sizeof(s.units), "%s", m.units);
+        s.id = m.id;
+        s.bitStart = m.bit_start;
+        s.length = m.length;
+        s.min = m.min;
+        s.max = m.max;
+        s.scale = m.scale;
+        s.firstValue = firstValue;
+        s.elements = signalElements(m);
+        firstValue += s.elements;
+    }
+
+    header->version = SNAPSHOT_VERSION;
+    header->headerSize = sizeof(SnapshotHeader);
+    header->signalSize = sizeof(SnapshotSignal);
+    header->valueSize = sizeof(SnapshotValue);
+    header->signalCount = count;
+    header->valueCount = valueCount;
+    header->segmentSize = bytes;
+    header->tableHash = snapshotTableHash();
+    header->publisherPid = (uint32_t)getpid();
+    header->live.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+
+    snprintf(segmentName, sizeof(segmentName), "%s", name);
+    depth = 0;
+    newestUs = 0;
+    return true;
+}
+
+void SnapshotPublisher::close(bool unlink) {
+    if (header == nullptr) return;
+    header->live.store(0, std::memory_order_release);
+    munmap(header, size);
+    if (unlink) shm_unlink(segmentName);
+    header = nullptr;
+    signals = nullptr;
+    values = nullptr;
+}
+
+void SnapshotPublisher::begin() {
+    if (header == nullptr || depth++ > 0) return;
+    // Odd sequence first, then the value stores may not move above it
+    header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SnapshotPublisher::end() {
+    if (header == nullptr || depth == 0 || --depth > 0) return;
+    header->lastUs.store(newestUs, std::memory_order_relaxed);
+    header->publishes.fetch_add(1, std::memory_order_relaxed);
+    header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void SnapshotPublisher::store(int index, int element, float value, uint64_t timestampUs) {
+    SnapshotValue& slot = values[signals[index].firstValue + element];
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.timestampUs.store(timestampUs, std::memory_order_relaxed);
+    slot.updates.store(slot.updates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (timestampUs > newestUs) newestUs = timestampUs;
+}
+
+void SnapshotPublisher::publishFrame(uint64_t timestampUs, const CanMessage* const* definitions, const float* values,
+                                     int count) {
+    if (header == nullptr || count <= 0) return;
+    begin();
+    for (int i = 0; i < count; i++) {
+        int index = BDRCANLib::findMessageIndex(definitions[i]);
+        if (index >= 0) store(index, 0, values[i], timestampUs);
+    }
+    end();
+}
+
+void SnapshotPublisher::publishResponse(uint64_t timestampUs, const OBD2Response& response) {
+    if (header == nullptr) return;
+    int index = BDRCANLib::findMessageIndex(response.definition);
+    if (index < 0) return;
+    int count = response.count;
+    if (count > (int)signals[index].elements) count = signals[index].elements;
+
+    begin();
+    for (int i = 0; i < count; i++) store(index, i, response.values[i], timestampUs);
+    end();
+}
+
+void SnapshotPublisher::publish(int index, float value, uint64_t timestampUs, int element) {
+    if (header == nullptr || index < 0 || index >= (int)header->signalCount) return;
+    if (element < 0 || element >= (int)signals[index].elements) return;
+    begin();
+    store(index, element, value, timestampUs);
+    end();
+}
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+bool SnapshotReader::open(const char* name) {
+    close();
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(SnapshotHeader)) {
+        base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    // The magic is written last: with it in place, the rest of the layout is too
+    const SnapshotHeader* h = (const SnapshotHeader*)base;
+    bool valid = memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t expected = sizeof(SnapshotHeader) + (size_t)h->signalCount * sizeof(SnapshotSignal)
+                    + (size_t)h->valueCount * sizeof(SnapshotValue);
+    if (!valid || h->version != SNAPSHOT_VERSION
+        || h->headerSize != sizeof(SnapshotHeader) || h->signalSize != sizeof(SnapshotSignal)
+        || h->valueSize != sizeof(SnapshotValue) || h->segmentSize != (uint64_t)info.st_size
+        || expected != (size_t)info.st_size) {
+        munmap(base, info.st_size);
+        return false;
+    }
+
+    header = h;
+    signals = (const SnapshotSignal*)(h + 1);
+    values = (const SnapshotValue*)(signals + h->signalCount);
+    size = info.st_size;
+    matchesTable = h->tableHash == snapshotTableHash();
+    return true;
+}
+
+void SnapshotReader::close() {
+    if (header == nullptr) return;
+    munmap((void*)header, size);
+    header = nullptr;
+    signals = nullptr;
+    values = nullptr;
+}
+
+int SnapshotReader::findSignal(const char* name) const {
+    for (int i = 0; i < signalCount(); i++) {
+        if (strcasecmp(signals[i].name, name) == 0) return i;
+    }
+    for (int i = 0; i < signalCount(); i++) {
+        if (signals[i].alt[0] != '\0' && strcasecmp(signals[i].alt, name) == 0) return i;
+    }
+    return -1;
+}
+
+bool SnapshotReader::begin(uint32_t& sequence, int spins) const {
+    for (int i = 0; i < spins; i++) {
+        sequence = header->sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0) return true;
+    }
+    return false;
+}
+
+bool SnapshotReader::retry(uint32_t sequence) const {
+    // The value loads above may not move below the second sequence load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header->sequence.load(std::memory_order_relaxed) != sequence;
+}
+
+bool SnapshotReader::read(const int* indices, int count, float* out, int attempts) const {
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        uint32_t sequence;
+        if (!begin(sequence)) return false;
+        for (int i = 0; i < count; i++) {
+            out[i] = isSet(indices[i]) ? value(indices[i]) : NAN;
+        }
+        if (!retry(sequence)) return true;
+    }
+    return false;
+}
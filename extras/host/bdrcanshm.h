@@ -0,0 +1,170 @@
+/*
+    bdrcanshm.h - Decoded signal snapshot in POSIX shared memory, for several local readers.
+
+    One process owns the bus and publishes every decoded value into a shared-memory segment
+    (shm_open / mmap). Dashboards, loggers and strategy tools on the same box map the segment
+    read-only and read the values in place: no socket, no decoding and no system call per read.
+
+    Layout: SnapshotHeader | SnapshotSignal[signalCount] | SnapshotValue[valueCount]
+    The signal records copy the CanMessage table (name, alt, units, ID, bit layout, scale,
+    limits), so a reader built against another table can still find signals by name;
+    sameTable() says whether indices match the reader's own getAllMessages(). Cell arrays
+    take one value slot per element.
+
+    Consistency is a seqlock: the publisher makes sequence odd, stores the values and makes it
+    even again. A reader notes sequence, reads what it needs and retries if sequence moved, so
+    a group of values read together comes from one publish. Readers never write the segment
+    and cannot stall the publisher.
+    */
+
+    #ifndef bdrcanshm_h
+    #define bdrcanshm_h
+    #include <atomic>
+    #include <stddef.h>
+    #include <stdint.h>
+    #include "bdrcanisotp.h"
+    #include "bdrcanlib.h"
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                  "shared-memory snapshot needs lock-free atomics");
+
+    static const uint32_t SNAPSHOT_VERSION = 1;
+
+    struct SnapshotHeader {
+        char magic[8];                          // "BDRSHM\0\0"
+        uint32_t version;                       // SNAPSHOT_VERSION
+        uint32_t headerSize;                    // sizeof(SnapshotHeader)
+        uint32_t signalSize;                    // sizeof(SnapshotSignal)
+        uint32_t valueSize;                     // sizeof(SnapshotValue)
+        uint32_t signalCount;
+        uint32_t valueCount;
+        uint64_t segmentSize;
+        uint64_t tableHash;                     // of the publisher's CanMessage table
+        uint32_t publisherPid;
+        std::atomic<uint32_t> live;             // 0 once the publisher has closed the segment
+        alignas(64) std::atomic<uint32_t> sequence;     // odd while a publish is in progress
+        std::atomic<uint64_t> publishes;        // completed publishes
+        std::atomic<uint64_t> lastUs;           // newest timestamp published
+    };
+
+    struct SnapshotSignal {
+        char name[48];
+        char alt[48];
+        char units[16];
+        uint32_t id;
+        int32_t bitStart;
+        int32_t length;
+        float min;
+        float max;
+        float scale;
+        uint32_t firstValue;                    // index of the first SnapshotValue
+        uint32_t elements;                      // 12 for cell arrays, else 1
+    };
+
+    struct SnapshotValue {
+        std::atomic<float> value;
+        std::atomic<uint32_t> updates;          // 0 until the value is first published
+        std::atomic<uint64_t> timestampUs;
+    };
+
+    class SnapshotPublisher {
+    public:
+        SnapshotPublisher() {}
+        ~SnapshotPublisher();
+
+        // Create the segment ("/bdrcan" by default), replacing a stale one; errors go to stderr
+        bool open(const char* name = DEFAULT_NAME);
+        void close(bool unlink = true);
+        bool isOpen() const { return header != nullptr; }
+
+        // Publishes between begin() and end() reach readers together, as one seqlock write.
+        // Without them every publish call below is a write of its own.
+        void begin();
+        void end();
+
+        // values[i] belongs to definitions[i], as decodeFrame returns them
+        void publishFrame(uint64_t timestampUs, const CanMessage* const* definitions, const float* values, int count);
+
+        // A reassembled BMS response, every element of arrays
+        void publishResponse(uint64_t timestampUs, const OBD2Response& response);
+
+        // One value by getAllMessages() index
+        void publish(int index, float value, uint64_t timestampUs, int element = 0);
+
+        static constexpr const char* DEFAULT_NAME = "/bdrcan";
+
+    private:
+        SnapshotPublisher(const SnapshotPublisher&) = delete;
+        SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+        void store(int index, int element, float value, uint64_t timestampUs);
+
+        SnapshotHeader* header = nullptr;
+        SnapshotSignal* signals = nullptr;
+        SnapshotValue* values = nullptr;
+        size_t size = 0;
+        int depth = 0;                          // begin() nesting
+        uint64_t newestUs = 0;
+        char segmentName[64] = {};
+    };
+
+    class SnapshotReader {
+    public:
+        SnapshotReader() {}
+        ~SnapshotReader();
+
+        // Map a published segment read-only; false if it is missing or not a snapshot
+        bool open(const char* name = SnapshotPublisher::DEFAULT_NAME);
+        void close();
+        bool isOpen() const { return header != nullptr; }
+
+        // False once the publisher has gone; open() again to follow a new one
+        bool isLive() const { return header->live.load(std::memory_order_acquire) != 0; }
+
+        // Indices match this process's BDRCANLib::getAllMessages()
+        bool sameTable() const { return matchesTable; }
+
+        int signalCount() const { return (int)header->signalCount; }
+        const SnapshotSignal& signal(int index) const { return signals[index]; }
+
+        // Signal index by name or alt name, ignoring case; -1 if unknown
+        int findSignal(const char* name) const;
+
+        // Seqlock read: s = begin(), read values, and start over while retry(s).
+        // begin() waits out a publish in progress, up to spins polls; false if it did not end.
+        bool begin(uint32_t& sequence, int spins = 1 << 20) const;
+        bool retry(uint32_t sequence) const;
+
+        // Values in place; check them with retry() before relying on a group of them
+        float value(int index, int element = 0) const {
+            return values[signals[index].firstValue + element].value.load(std::memory_order_relaxed);
+        }
+        uint64_t timestampUs(int index, int element = 0) const {
+            return values[signals[index].firstValue + element].timestampUs.load(std::memory_order_relaxed);
+        }
+        bool isSet(int index, int element = 0) const {
+            return values[signals[index].firstValue + element].updates.load(std::memory_order_relaxed) != 0;
+        }
+
+        // Copy a consistent set of values (NAN for signals never published); false if the
+        // publisher kept writing for all attempts
+        bool read(const int* indices, int count, float* out, int attempts = 64) const;
+
+        uint64_t publishes() const { return header->publishes.load(std::memory_order_acquire); }
+        uint64_t lastUs() const { return header->lastUs.load(std::memory_order_acquire); }
+
+    private:
+        SnapshotReader(const SnapshotReader&) = delete;
+        SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+        const SnapshotHeader* header = nullptr;
+        const SnapshotSignal* signals = nullptr;
+        const SnapshotValue* values = nullptr;
+        size_t size = 0;
+        bool matchesTable = false;
+    };
+
+    // FNV-1a over the table's names and layouts; equal hashes mean equal indices
+    uint64_t snapshotTableHash();
+
+#endif
@@ -0,0 +1,410 @@
+#include "Arduino.h"
+#include "bdrcansim.h"
+#include "bdrcanisotp.h"
+#include <math.h>
+#include <strings.h>
+
+float SimWaveform::at(double timeS, std::mt19937& random) const {
+    double phase = (periodS > 0) ? fmod(timeS, periodS) / periodS : 0;
+    switch (shape) {
+        case SINE:
+            return low + (high - low) * (float)(0.5 + 0.5 * sin(2 * M_PI * phase));
+        case RAMP:
+            return low + (high - low) * (float)phase;
+        case SQUARE:
+            return (phase < 0.5) ? low : high;
+        case NOISE:
+            return low + (high - low) * (float)std::uniform_real_distribution<double>(0, 1)(random);
+        case CONSTANT:
+        default:
+            return low;
+    }
+}
+
+bool SimWaveform::parse(const char* text) {
+    static const char* const SHAPES[] = { "constant", "sine", "ramp", "square", "noise" };
+
+    const char* colon = strchr(text, ':');
+    size_t nameLength = colon ? (size_t)(colon - text) : strlen(text);
+    int found = -1;
+    for (int i = 0; i < (int)(sizeof(SHAPES) / sizeof(SHAPES[0])); i++) {
+        if (strlen(SHAPES[i]) == nameLength && strncasecmp(SHAPES[i], text, nameLength) == 0) found = i;
+    }
+    if (found < 0) return false;
+    shape = (Shape)found;
+
+    float* fields[] = { &low, &high, &periodS };
+    for (float* field : fields) {
+        if (colon == nullptr) break;
+        text = colon + 1;
+        colon = strchr(text, ':');
+        if (*text != ':' && *text != '\0') *field = strtof(text, nullptr);
+    }
+    // A constant is low; "constant:5" reads naturally as 5
+    if (shape == CONSTANT) high = low;
+    return true;
+}
+
+SimWaveform& simWaveform(int index) {
+    static std::vector<SimWaveform> waveforms;
+    if (waveforms.empty()) {
+        int count;
+        const CanMessage* const* all = BDRCANLib::getAllMessages(&count);
+        waveforms.resize(count);
+        for (int i = 0; i < count; i++) {
+            const CanMessage& m = *all[i];
+            SimWaveform& w = waveforms[i];
+#if BDRCAN_INVERTER_FEEDBACK
+            if (all[i] == &fault_code) {
+                w.shape = SimWaveform::CONSTANT;
+                continue;
+            }
+#endif
+            if (m.length == 1) {
+                w.shape = SimWaveform::SQUARE;
+                w.low = 0;
+                w.high = 1;
+                w.periodS = 2 + i % 5;
+            } else {
+                w.shape = SimWaveform::SINE;
+                w.low = m.min + 0.25f * (m.max - m.min);
+                w.high = m.min + 0.75f * (m.max - m.min);
+                w.periodS = 1 + i % 7;
+            }
+        }
+    }
+    return waveforms[index];
+}
+
+void simEncode(const CanMessage* const* definitions, int count, double timeS, std::mt19937& random,
+               uint8_t* data, int elements) {
+    const CanMessage* const* all = BDRCANLib::getAllMessages();
+    for (int e = 0; e < elements; e++) {
+        for (int i = 0; i < count; i++) {
+            const CanMessage& m = *definitions[i];
+            // Elements of an array run slightly out of phase so the cells differ
+            float value = simWaveform((int)(definitions + i - all)).at(timeS + e * 0.37, random);
+            if (BDRCANLib::isBMSMessage(&m)) {
+                BDRCANLib::encodeBMSValue(value, m, data + e * (m.length / 8));
+            } else {
+                BDRCANLib::encodeInverterValue(value, m, data);
+            }
+        }
+    }
+}
+
+static bool chance(std::mt19937& random, double rate) {
+    return rate > 0 && std::uniform_real_distribution<double>(0, 1)(random) < rate;
+}
+
+SimBus::SimBus(uint32_t bitrate, int rxDepth, int txDepth)
+    : bitrate(bitrate), rxDepth(rxDepth), txDepth(txDepth), random(1), rx(rxDepth), latency(LATENCY_BUCKETS + 1) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void SimBus::setFaults(const SimFaults* faults, uint32_t seed) {
+    this->faults = faults;
+    random.seed(seed);
+}
+
+double SimBus::frameUs(uint8_t length) const {
+    // SOF..EOF + intermission is 47 bits plus data; stuffing adds up to one bit in four of
+    // the 34 + 8n bits it applies to
+    int bits = 47 + 8 * length + (34 + 8 * length - 1) / 4;
+    return bits * 1e6 / bitrate;
+}
+
+bool SimBus::send(const CANMessage& frame) {
+    if (txCount >= txDepth) {
+        stats.txRejected++;
+        return false;
+    }
+    pending.push_back({frame, nowUs, true});
+    txCount++;
+    return true;
+}
+
+bool SimBus::receive(CANMessage& frame) {
+    if (rxCount == 0) return false;
+    const Received& r = rx[rxHead];
+    frame = r.frame;
+    rxHead = (rxHead + 1) % rxDepth;
+    rxCount--;
+
+    double waited = nowUs - r.dueUs;
+    if (waited < 0) waited = 0;
+    latency[waited < LATENCY_BUCKETS ? (int)waited : LATENCY_BUCKETS]++;
+    if (waited > maxLatency) maxLatency = waited;
+    stats.delivered++;
+    return true;
+}
+
+bool SimBus::available() {
+    return rxCount != 0;
+}
+
+void SimBus::post(const CANMessage& frame, double dueUs) {
+    pending.push_back({frame, dueUs, false});
+}
+
+void SimBus::run(double untilUs) {
+    nowUs = untilUs;
+    while (!pending.empty()) {
+        double earliest = pending[0].dueUs;
+        for (const Pending& p : pending) {
+            if (p.dueUs < earliest) earliest = p.dueUs;
+        }
+        double start = (busFreeUs > earliest) ? busFreeUs : earliest;
+
+        // Arbitration among everything waiting at start: lowest ID, then oldest
+        size_t winner = pending.size();
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (pending[i].dueUs > start) continue;
+            if (winner == pending.size() || pending[i].frame.id < pending[winner].frame.id
+                || (pending[i].frame.id == pending[winner].frame.id && pending[i].dueUs < pending[winner].dueUs)) {
+                winner = i;
+            }
+        }
+
+        uint8_t length = (pending[winner].frame.len > 8) ? 8 : pending[winner].frame.len;
+        double wireUs = frameUs(length);
+        if (start + wireUs > untilUs) break;
+
+        if (faults != nullptr && chance(random, faults->errorRate)) {
+            // Error flag + delimiter after about half the frame; the sender retries
+            double errorUs = wireUs / 2 + 20 * 1e6 / bitrate;
+            busFreeUs = start + errorUs;
+            stats.busyUs += errorUs;
+            stats.errors++;
+            continue;
+        }
+
+        Pending p = pending[winner];
+        pending.erase(pending.begin() + winner);
+        busFreeUs = start + wireUs;
+        stats.busyUs += wireUs;
+        stats.frames++;
+
+        bool lost = faults != nullptr && chance(random, faults->dropRate);
+        if (lost) stats.dropped++;
+
+        if (p.fromNode) {
+            txCount--;
+            stats.nodeSent++;
+            if (!lost && peer != nullptr) peer->onFrame(p.frame, busFreeUs);
+            continue;
+        }
+        if (lost) continue;
+
+        if (rxCount == rxDepth) {
+            stats.overruns++;
+            continue;
+        }
+        rx[(rxHead + rxCount) % rxDepth] = {p.frame, p.dueUs};
+        rxCount++;
+        if ((uint32_t)rxCount > stats.maxRxDepth) stats.maxRxDepth = rxCount;
+    }
+    stats.elapsedUs = untilUs;
+}
+
+double SimBus::latencyUs(double p) const {
+    if (stats.delivered == 0) return 0;
+    uint64_t target = (uint64_t)ceil(p * stats.delivered);
+    uint64_t seen = 0;
+    for (int i = 0; i <= LATENCY_BUCKETS; i++) {
+        seen += latency[i];
+        if (seen >= target) return (i < LATENCY_BUCKETS) ? i : maxLatency;
+    }
+    return maxLatency;
+}
+
+InverterSim::InverterSim(SimBus& bus) : bus(bus), random(2) {
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        const CanMessage* first = BDRCANLib::getSlotMessages(slot)[0];
+        if (!BDRCANLib::isInverterMessage(first) || first->id < 0x20) continue;
+
+        int count;
+        const CanMessage* const* defs = BDRCANLib::getSlotMessages(slot, &count);
+        uint8_t length = 0;
+        for (int i = 0; i < count; i++) {
+            int bytes = (defs[i]->bit_start + defs[i]->length + 7) / 8;
+            if (bytes > length) length = (bytes > 8) ? 8 : bytes;
+        }
+        broadcasts.push_back({first->id, length, 10000, 0});
+    }
+    setPeriod(10000);
+}
+
+double InverterSim::cycleUs() const {
+    double total = 0;
+    for (const Broadcast& b : broadcasts) total += bus.frameUs(b.length);
+    return total;
+}
+
+void InverterSim::setPeriod(uint32_t periodUs) {
+    // Spread the IDs across the period, as the inverter does not send them in one burst
+    for (size_t i = 0; i < broadcasts.size(); i++) {
+        broadcasts[i].periodUs = periodUs;
+        broadcasts[i].dueUs = (double)periodUs * i / broadcasts.size();
+    }
+}
+
+bool InverterSim::setPeriod(uint32_t id, uint32_t periodUs) {
+    for (Broadcast& b : broadcasts) {
+        if (b.id != id) continue;
+        b.periodUs = periodUs;
+        return true;
+    }
+    return false;
+}
+
+void InverterSim::update(double nowUs) {
+    for (Broadcast& b : broadcasts) {
+        if (b.periodUs == 0) continue;
+        while (b.dueUs <= nowUs) {
+            int count;
+            const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(b.id), &count);
+
+            CANMessage frame;
+            frame.id = b.id;
+            frame.len = b.length;
+            simEncode(defs, count, b.dueUs / 1e6, random, frame.data);
+
+#if BDRCAN_INVERTER_FEEDBACK
+            double timeS = b.dueUs / 1e6;
+            if (faults != nullptr && b.id == fault_code.id && faults->faultDurationS > 0
+                && timeS >= faults->faultStartS && timeS < faults->faultStartS + faults->faultDurationS) {
+                BDRCANLib::encodeInverterValue(faults->faultCode, fault_code, frame.data);
+            }
+#endif
+
+            bus.post(frame, b.dueUs);
+            b.dueUs += b.periodUs;
+        }
+    }
+}
+
+BMSSim::BMSSim(SimBus& bus) : bus(bus), random(3) {
+    memset(&stats, 0, sizeof(stats));
+    bus.attach(this);
+}
+
+void BMSSim::onFrame(const CANMessage& frame, double atUs) {
+    if (frame.id == BDRCANLib::OBD2_REQUEST_ID && frame.len >= 4 && frame.data[0] >= 3 && frame.data[1] == 0x22) {
+        stats.requests++;
+        // A new request abandons a transfer still waiting for flow control
+        waitingForFlowControl = false;
+        if (faults != nullptr && chance(random, faults->bmsSilentRate)) {
+            stats.silent++;
+            return;
+        }
+        respond((frame.data[2] << 8) | frame.data[3], atUs + responseDelayUs);
+        return;
+    }
+
+    // Flow control from the node: 0x30 continue, 0x31 wait, 0x32 overflow
+    if (frame.id == BDRCANIsoTp::FLOW_CONTROL_ID && frame.len >= 3 && waitingForFlowControl && (frame.data[0] & 0xF0) == 0x30) {
+        uint8_t status = frame.data[0] & 0x0F;
+        if (status == 0) {
+            sendConsecutive(atUs, frame.data[2], frame.data[1]);
+        } else if (status != 1) {
+            waitingForFlowControl = false;
+        }
+    }
+}
+
+void BMSSim::respond(uint16_t pid, double atUs) {
+    CANMessage frame;
+    frame.id = BDRCANIsoTp::RESPONSE_ID;
+    frame.len = 8;
+
+    int slot = BDRCANLib::findSlotByID(pid);
+    const CanMessage* first = (slot >= 0) ? BDRCANLib::getSlotMessages(slot)[0] : nullptr;
+    if (first == nullptr || !BDRCANLib::isBMSMessage(first)
+        || (faults != nullptr && chance(random, faults->bmsNegativeRate))) {
+        // Negative response: request out of range
+        frame.data[0] = 0x03;
+        frame.data[1] = 0x7F;
+        frame.data[2] = 0x22;
+        frame.data[3] = 0x31;
+        bus.post(frame, atUs);
+        stats.negative++;
+        return;
+    }
+
+    int count;
+    const CanMessage* const* defs = BDRCANLib::getSlotMessages(slot, &count);
+    int elements = (pid >= 0xF100) ? ARRAY_ELEMENTS : 1;
+    uint16_t dataLength = 0;
+    for (int i = 0; i < count; i++) {
+        uint16_t end = defs[i]->bit_start / 8 + elements * (defs[i]->length / 8);
+        if (end > dataLength) dataLength = end;
+    }
+
+    memset(payload, 0, sizeof(payload));
+    payload[0] = 0x62;
+    payload[1] = pid >> 8;
+    payload[2] = pid & 0xFF;
+    simEncode(defs, count, atUs / 1e6, random, &payload[3], elements);
+    payloadLength = 3 + dataLength;
+    stats.responses++;
+
+    if (payloadLength <= 7) {
+        frame.data[0] = payloadLength;
+        memcpy(&frame.data[1], payload, payloadLength);
+        bus.post(frame, atUs);
+        return;
+    }
+
+    // First frame: 12-bit length and the first six bytes, then wait for flow control
+    frame.data[0] = 0x10 | (payloadLength >> 8);
+    frame.data[1] = payloadLength & 0xFF;
+    memcpy(&frame.data[2], payload, 6);
+    bus.post(frame, atUs);
+    payloadSent = 6;
+    sequence = 1;
+    waitingForFlowControl = true;
+    firstFrameUs = atUs;
+    stats.multiFrame++;
+}
+
+void BMSSim::sendConsecutive(double atUs, uint8_t separationMin, uint8_t blockSize) {
+    // STmin: 0-0x7F milliseconds, 0xF1-0xF9 hundreds of microseconds
+    double gapUs = (separationMin <= 0x7F) ? separationMin * 1000.0
+                 : (separationMin >= 0xF1 && separationMin <= 0xF9) ? (separationMin - 0xF0) * 100.0 : 127000.0;
+
+    waitingForFlowControl = false;
+    double dueUs = atUs;
+    int inBlock = 0;
+    while (payloadSent < payloadLength) {
+        CANMessage frame;
+        frame.id = BDRCANIsoTp::RESPONSE_ID;
+        frame.len = 8;
+        uint16_t chunk = payloadLength - payloadSent;
+        if (chunk > 7) chunk = 7;
+        frame.data[0] = 0x20 | sequence;
+        memcpy(&frame.data[1], &payload[payloadSent], chunk);
+
+        if (faults != nullptr && chance(random, faults->isotpDropRate)) {
+            stats.consecutiveDropped++;
+        } else {
+            bus.post(frame, dueUs);
+        }
+        sequence = (sequence + 1) & 0x0F;
+        payloadSent += chunk;
+        dueUs += gapUs;
+
+        if (blockSize != 0 && ++inBlock == blockSize && payloadSent < payloadLength) {
+            waitingForFlowControl = true;
+            firstFrameUs = dueUs;
+            return;
+        }
+    }
+}
+
+void BMSSim::update(double nowUs) {
+    if (waitingForFlowControl && nowUs - firstFrameUs > FLOW_CONTROL_TIMEOUT_US) {
+        stats.flowControlTimeouts++;
+        waitingForFlowControl = false;
+    }
+}
@@ -0,0 +1,223 @@
+/*
+    bdrcansim.h - Simulated inverter and BMS traffic for load tests on the host.
+
+    SimBus is a CANBackend for ACAN_T4 that models one bus: frames take their wire time at
+    the configured bitrate, lower IDs win arbitration, the controller's receive FIFO overruns
+    when the node falls behind, and its transmit mailboxes reject sends when full.
+    InverterSim broadcasts every inverter feedback ID (0x20 and up) from the CanMessage table
+    at a configurable period. BMSSim answers the mode 0x22 requests of sendOBD2Request as
+    the Orion does: single frames, or ISO-TP first + consecutive frames paced by the node's
+    flow control. Signal values follow per-signal waveforms; faults are injected at random.
+
+    Time is in microseconds of simulated time, passed in by the caller (run / update).
+    */
+
+    #ifndef bdrcansim_h
+    #define bdrcansim_h
+    #include <ACAN_T4.h>
+    #include <random>
+    #include <vector>
+    #include "bdrcanlib.h"
+
+    struct SimWaveform {
+        enum Shape {
+            CONSTANT,           // low
+            SINE,               // low..high, one cycle per period
+            RAMP,               // low rising to high, then again from low
+            SQUARE,             // low for half a period, then high
+            NOISE               // uniform in low..high
+        };
+
+        Shape shape = SINE;
+        float low = 0;
+        float high = 0;
+        float periodS = 1;
+
+        float at(double timeS, std::mt19937& random) const;
+
+        // "sine:0:8000:2" -> shape:low:high:period seconds; missing fields keep their value
+        bool parse(const char* text);
+    };
+
+    struct SimFaults {
+        double dropRate = 0;            // frames lost on the wire, never received
+        double errorRate = 0;           // error frame, then retransmission: costs bus time
+        double bmsSilentRate = 0;       // requests the BMS does not answer
+        double bmsNegativeRate = 0;     // requests answered with 0x7F
+        double isotpDropRate = 0;       // consecutive frames the BMS never sends
+        uint16_t faultCode = 0;         // fault_code broadcast during the window below
+        double faultStartS = 0;
+        double faultDurationS = 0;
+    };
+
+    struct SimBusStats {
+        uint64_t frames;                // frames completed on the wire, both directions
+        uint64_t delivered;             // frames the node received
+        uint64_t nodeSent;              // frames the node transmitted
+        uint64_t dropped;               // injected losses
+        uint64_t errors;                // injected error frames
+        uint64_t overruns;              // receive FIFO full, frame lost
+        uint64_t txRejected;            // node sends refused, transmit mailboxes full
+        uint32_t maxRxDepth;            // receive FIFO high-water mark
+        double busyUs;                  // wire time, including error frames
+        double elapsedUs;               // simulated time covered by run()
+    };
+
+    class SimPeer;
+
+    class SimBus : public CANBackend {
+    public:
+        SimBus(uint32_t bitrate = 1000000, int rxDepth = 64, int txDepth = 16);
+
+        // CANBackend, the node's side
+        bool send(const CANMessage& frame) override;
+        bool receive(CANMessage& frame) override;
+        bool available() override;
+
+        // Peer side: queue a frame for arbitration once simulated time reaches dueUs
+        void post(const CANMessage& frame, double dueUs);
+
+        // Frames the node transmits are handed to this peer when they complete
+        void attach(SimPeer* peer) { this->peer = peer; }
+        void setFaults(const SimFaults* faults, uint32_t seed);
+
+        // Put every frame that completes by nowUs on the wire
+        void run(double nowUs);
+
+        // Wire time of a standard frame with worst-case bit stuffing
+        double frameUs(uint8_t length) const;
+
+        const SimBusStats& getStats() const { return stats; }
+
+        // Receive latency (due time to receive()) percentile in microseconds, 0 < p <= 1
+        double latencyUs(double p) const;
+        double maxLatencyUs() const { return maxLatency; }
+
+    private:
+        struct Pending {
+            CANMessage frame;
+            double dueUs;
+            bool fromNode;
+        };
+
+        struct Received {
+            CANMessage frame;
+            double dueUs;
+        };
+
+        uint32_t bitrate;
+        int rxDepth;
+        int txDepth;
+        int txCount = 0;
+        SimPeer* peer = nullptr;
+        const SimFaults* faults = nullptr;
+        std::mt19937 random;
+
+        std::vector<Pending> pending;
+        std::vector<Received> rx;       // ring of rxDepth
+        int rxHead = 0;
+        int rxCount = 0;
+        double busFreeUs = 0;
+        double nowUs = 0;
+
+        // 1 us buckets up to LATENCY_BUCKETS, the last bucket collects the rest
+        static const int LATENCY_BUCKETS = 100000;
+        std::vector<uint32_t> latency;
+        double maxLatency = 0;
+
+        SimBusStats stats;
+    };
+
+    class SimPeer {
+    public:
+        virtual ~SimPeer() {}
+        virtual void onFrame(const CANMessage& frame, double atUs) = 0;
+    };
+
+    class InverterSim {
+    public:
+        explicit InverterSim(SimBus& bus);
+
+        // Broadcast period of every ID, or of one; 0 stops the ID
+        void setPeriod(uint32_t periodUs);
+        bool setPeriod(uint32_t id, uint32_t periodUs);
+
+        void setFaults(const SimFaults* faults) { this->faults = faults; }
+
+        // Post every broadcast due by nowUs
+        void update(double nowUs);
+
+        int idCount() const { return (int)broadcasts.size(); }
+
+        // Wire time of one broadcast of every ID
+        double cycleUs() const;
+
+    private:
+        struct Broadcast {
+            uint32_t id;
+            uint8_t length;             // bytes covering every signal of the ID
+            uint32_t periodUs;
+            double dueUs;
+        };
+
+        SimBus& bus;
+        const SimFaults* faults = nullptr;
+        std::vector<Broadcast> broadcasts;
+        std::mt19937 random;
+    };
+
+    struct BMSSimStats {
+        uint32_t requests;              // mode 0x22 requests received
+        uint32_t responses;             // positive responses started
+        uint32_t negative;              // 0x7F answers (unknown PID or injected)
+        uint32_t silent;                // requests ignored (injected)
+        uint32_t multiFrame;            // responses sent as ISO-TP first + consecutive frames
+        uint32_t consecutiveDropped;    // consecutive frames withheld (injected)
+        uint32_t flowControlTimeouts;   // first frames never answered with flow control (N_Bs)
+    };
+
+    class BMSSim : public SimPeer {
+    public:
+        explicit BMSSim(SimBus& bus);
+
+        void setResponseDelay(uint32_t delayUs) { responseDelayUs = delayUs; }
+        void setFaults(const SimFaults* faults) { this->faults = faults; }
+
+        void onFrame(const CANMessage& frame, double atUs) override;
+
+        // Drop a response whose flow control never came
+        void update(double nowUs);
+
+        const BMSSimStats& getStats() const { return stats; }
+
+        static const uint32_t FLOW_CONTROL_TIMEOUT_US = 1000000;   // N_Bs
+        static const int ARRAY_ELEMENTS = 12;                       // PIDs 0xF100 and up
+
+    private:
+        void respond(uint16_t pid, double atUs);
+        void sendConsecutive(double atUs, uint8_t separationMin, uint8_t blockSize);
+
+        SimBus& bus;
+        const SimFaults* faults = nullptr;
+        uint32_t responseDelayUs = 1000;
+        std::mt19937 random;
+        BMSSimStats stats;
+
+        // One transfer at a time, as the Orion answers requests in turn
+        uint8_t payload[64];
+        uint16_t payloadLength = 0;
+        uint16_t payloadSent = 0;
+        uint8_t sequence = 0;
+        bool waitingForFlowControl = false;
+        double firstFrameUs = 0;
+    };
+
+    // Waveform of a signal: defaults to a sine through the middle half of its range (a square
+    // wave for 1-bit flags, constant 0 for fault_code); index is the getAllMessages() index
+    SimWaveform& simWaveform(int index);
+
+    // Value of every signal of definition's ID at timeS, encoded as the device sends it
+    void simEncode(const CanMessage* const* definitions, int count, double timeS, std::mt19937& random,
+                   uint8_t* data, int elements = 1);
+
+#endif
@@ -0,0 +1,208 @@
+#include "bdrcansimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BDRCAN_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BDRCAN_SIMD_X86 0
+#endif
+
+// Same arithmetic and clamp order as the BMS decoders in bdrcanlib.cpp
+static inline float scaleSample(int32_t raw, float scale, float minValue, float maxValue) {
+    float value = (float)raw * scale;
+    if (value < minValue) value = minValue;
+    if (value > maxValue) value = maxValue;
+    return value;
+}
+
+static inline int32_t loadSample(const uint8_t* data, bool isSigned) {
+    uint16_t bits = (uint16_t)((data[0] << 8) | data[1]);
+    return isSigned ? (int32_t)(int16_t)bits : (int32_t)bits;
+}
+
+static void unpackScalar(const uint8_t* data, size_t count, bool isSigned, int32_t* out) {
+    for (size_t i = 0; i < count; i++) out[i] = loadSample(data + 2 * i, isSigned);
+}
+
+static void unpackScaledScalar(const uint8_t* data, size_t count, bool isSigned,
+                               float scale, float minValue, float maxValue, float* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = scaleSample(loadSample(data + 2 * i, isSigned), scale, minValue, maxValue);
+    }
+}
+
+#if BDRCAN_SIMD_X86
+
+// SSE2: 8 samples per iteration; swap bytes with shifts, widen by interleaving
+__attribute__((target("sse2")))
+static inline void widenSse2(__m128i samples, bool isSigned, __m128i* low, __m128i* high) {
+    __m128i swapped = _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8));
+    if (isSigned) {
+        // Each sample in the upper half of a 32-bit lane, then an arithmetic shift down
+        *low = _mm_srai_epi32(_mm_unpacklo_epi16(swapped, swapped), 16);
+        *high = _mm_srai_epi32(_mm_unpackhi_epi16(swapped, swapped), 16);
+    } else {
+        *low = _mm_unpacklo_epi16(swapped, _mm_setzero_si128());
+        *high = _mm_unpackhi_epi16(swapped, _mm_setzero_si128());
+    }
+}
+
+__attribute__((target("sse2")))
+static void unpackSse2(const uint8_t* data, size_t count, bool isSigned, int32_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low, high;
+        widenSse2(_mm_loadu_si128((const __m128i*)(data + 2 * i)), isSigned, &low, &high);
+        _mm_storeu_si128((__m128i*)(out + i), low);
+        _mm_storeu_si128((__m128i*)(out + i + 4), high);
+    }
+    unpackScalar(data + 2 * i, count - i, isSigned, out + i);
+}
+
+__attribute__((target("sse2")))
+static void unpackScaledSse2(const uint8_t* data, size_t count, bool isSigned,
+                             float scale, float minValue, float maxValue, float* out) {
+    const __m128 scales = _mm_set1_ps(scale);
+    const __m128 mins = _mm_set1_ps(minValue);
+    const __m128 maxs = _mm_set1_ps(maxValue);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low, high;
+        widenSse2(_mm_loadu_si128((const __m128i*)(data + 2 * i)), isSigned, &low, &high);
+        // max then min matches the scalar clamp order; no NaNs can come out of an integer
+        __m128 lowValues = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(low), scales), mins), maxs);
+        __m128 highValues = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(high), scales), mins), maxs);
+        _mm_storeu_ps(out + i, lowValues);
+        _mm_storeu_ps(out + i + 4, highValues);
+    }
+    unpackScaledScalar(data + 2 * i, count - i, isSigned, scale, minValue, maxValue, out + i);
+}
+
+// AVX2: 16 samples per iteration; one byte shuffle per 8 samples, then a widening move
+__attribute__((target("avx2")))
+static inline void widenAvx2(const uint8_t* data, bool isSigned, __m256i* low, __m256i* high) {
+    const __m128i swapBytes = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    __m128i first = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), swapBytes);
+    __m128i second = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), swapBytes);
+    if (isSigned) {
+        *low = _mm256_cvtepi16_epi32(first);
+        *high = _mm256_cvtepi16_epi32(second);
+    } else {
+        *low = _mm256_cvtepu16_epi32(first);
+        *high = _mm256_cvtepu16_epi32(second);
+    }
+}
+
+__attribute__((target("avx2")))
+static void unpackAvx2(const uint8_t* data, size_t count, bool isSigned, int32_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i low, high;
+        widenAvx2(data + 2 * i, isSigned, &low, &high);
+        _mm256_storeu_si256((__m256i*)(out + i), low);
+        _mm256_storeu_si256((__m256i*)(out + i + 8), high);
+    }
+    unpackScalar(data + 2 * i, count - i, isSigned, out + i);
+}
+
+__attribute__((target("avx2")))
+static void unpackScaledAvx2(const uint8_t* data, size_t count, bool isSigned,
+                             float scale, float minValue, float maxValue, float* out) {
+    const __m256 scales = _mm256_set1_ps(scale);
+    const __m256 mins = _mm256_set1_ps(minValue);
+    const __m256 maxs = _mm256_set1_ps(maxValue);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i low, high;
+        widenAvx2(data + 2 * i, isSigned, &low, &high);
+        __m256 lowValues = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(low), scales), mins), maxs);
+        __m256 highValues = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(high), scales), mins), maxs);
+        _mm256_storeu_ps(out + i, lowValues);
+        _mm256_storeu_ps(out + i + 8, highValues);
+    }
+    unpackScaledScalar(data + 2 * i, count - i, isSigned, scale, minValue, maxValue, out + i);
+}
+
+#endif
+
+typedef void (*UnpackKernel)(const uint8_t* data, size_t count, bool isSigned, int32_t* out);
+typedef void (*UnpackScaledKernel)(const uint8_t* data, size_t count, bool isSigned,
+                                   float scale, float minValue, float maxValue, float* out);
+
+// Indexed by SimdLevel; a level the build cannot target falls back to the one below it
+static const UnpackKernel UNPACK_KERNELS[SIMD_LEVEL_COUNT] = {
+#if BDRCAN_SIMD_X86
+    unpackScalar, unpackSse2, unpackAvx2
+#else
+    unpackScalar, unpackScalar, unpackScalar
+#endif
+};
+
+static const UnpackScaledKernel UNPACK_SCALED_KERNELS[SIMD_LEVEL_COUNT] = {
+#if BDRCAN_SIMD_X86
+    unpackScaledScalar, unpackScaledSse2, unpackScaledAvx2
+#else
+    unpackScaledScalar, unpackScaledScalar, unpackScaledScalar
+#endif
+};
+
+static const char* const SIMD_LEVEL_NAMES[SIMD_LEVEL_COUNT] = { "scalar", "sse2", "avx2" };
+
+SimdLevel simdDetect() {
+#if BDRCAN_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+static SimdLevel activeLevel = simdDetect();
+
+SimdLevel simdLevel() {
+    return activeLevel;
+}
+
+SimdLevel simdSetLevel(SimdLevel level) {
+    SimdLevel best = simdDetect();
+    if (level < SIMD_SCALAR) level = SIMD_SCALAR;
+    activeLevel = (level > best) ? best : level;
+    return activeLevel;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    return (level >= SIMD_SCALAR && level < SIMD_LEVEL_COUNT) ? SIMD_LEVEL_NAMES[level] : "";
+}
+
+void unpackBigEndian16(const uint8_t* data, size_t count, bool isSigned, int32_t* out) {
+    if (data == nullptr || out == nullptr) return;
+    UNPACK_KERNELS[activeLevel](data, count, isSigned, out);
+}
+
+void unpackBigEndian16Scaled(const uint8_t* data, size_t count, bool isSigned,
+                             float scale, float minValue, float maxValue, float* out) {
+    if (data == nullptr || out == nullptr) return;
+    UNPACK_SCALED_KERNELS[activeLevel](data, count, isSigned, scale, minValue, maxValue, out);
+}
+
+int decodeBMSArray(const uint8_t* data, size_t length, const CanMessage& definition,
+                   float* values, size_t maxValues) {
+    if (data == nullptr || values == nullptr) return 0;
+
+    // Anything but a 16-bit BMS field keeps the library's byte loop
+    if (!BDRCANLib::isBMSMessage(&definition) || definition.length != 16) {
+        static BDRCANLib lib;
+        int limit = (maxValues > 0x7FFFFFFF) ? 0x7FFFFFFF : (int)maxValues;
+        return lib.interpretBMSArray(data, (uint8_t)((length > 0xFF) ? 0xFF : length), definition, values, limit);
+    }
+
+    // Element layout as in interpretBMSArray: element i starts at i * 2, field at bit_start / 8
+    size_t offset = definition.bit_start / 8;
+    if (length < offset) return 0;
+    size_t count = (length - offset) / 2;
+    if (count > maxValues) count = maxValues;
+
+    unpackBigEndian16Scaled(data + offset, count, definition.min < 0,
+                            definition.scale, definition.min, definition.max, values);
+    return (int)count;
+}
@@ -0,0 +1,43 @@
+/*
+    bdrcansimd.h - Vector kernels for runs of big-endian 16-bit samples (host only).
+
+    The Orion cell arrays (cell_voltages_*, opencell_voltages_*, internal_resistances_*) are
+    big-endian 16-bit samples. These kernels byte-swap, widen and scale a whole payload run at
+    a time with AVX2 or SSE2, picked at runtime from what the CPU supports, with a scalar
+    fallback everywhere else. Results are bit-identical to interpretBMSArray.
+    */
+
+    #ifndef bdrcansimd_h
+    #define bdrcansimd_h
+    #include "Arduino.h"
+    #include "bdrcanlib.h"
+
+    // Kernel instruction sets, in increasing order
+    enum SimdLevel {
+        SIMD_SCALAR,
+        SIMD_SSE2,
+        SIMD_AVX2,
+        SIMD_LEVEL_COUNT
+    };
+
+    // Best level the CPU supports, and the level the kernels currently use (the best by default)
+    SimdLevel simdDetect();
+    SimdLevel simdLevel();
+
+    // Force a level, e.g. for benchmarks; capped at simdDetect(). Returns the level in use.
+    SimdLevel simdSetLevel(SimdLevel level);
+    const char* simdLevelName(SimdLevel level);
+
+    // count samples from data into raw integers: sign extended when isSigned, else zero extended
+    void unpackBigEndian16(const uint8_t* data, size_t count, bool isSigned, int32_t* out);
+
+    // count samples scaled like the BMS decoders: raw * scale, clamped to [minValue, maxValue]
+    void unpackBigEndian16Scaled(const uint8_t* data, size_t count, bool isSigned,
+                                 float scale, float minValue, float maxValue, float* out);
+
+    // interpretBMSArray for a reassembled payload, through the kernels when the definition is a
+    // 16-bit BMS field. Returns the number of values written.
+    int decodeBMSArray(const uint8_t* data, size_t length, const CanMessage& definition,
+                       float* values, size_t maxValues);
+
+#endif
@@ -0,0 +1,234 @@
+#include "bdrcansocketcan.h"
+#include "bdrcanlib.h"
+#include "bdrcanisotp.h"
+#include <errno.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+SocketCANBackend::SocketCANBackend() {
+    memset(&stats, 0, sizeof(stats));
+    for (int i = 0; i < BATCH; i++) {
+        rxVectors[i].iov_base = &rxFrames[i];
+        rxVectors[i].iov_len = sizeof(struct can_frame);
+        txVectors[i].iov_base = &txFrames[i];
+        txVectors[i].iov_len = sizeof(struct can_frame);
+    }
+}
+
+SocketCANBackend::~SocketCANBackend() {
+    close();
+}
+
+bool SocketCANBackend::open(const char* interface) {
+    close();
+
+    fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0) {
+        fprintf(stderr, "Error: SocketCAN socket: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct sockaddr_can address;
+    memset(&address, 0, sizeof(address));
+    address.can_family = AF_CAN;
+    address.can_ifindex = (int)if_nametoindex(interface);
+    if (address.can_ifindex == 0) {
+        fprintf(stderr, "Error: SocketCAN interface %s: %s\n", interface, strerror(errno));
+        close();
+        return false;
+    }
+
+    // Kernel receive timestamps and the socket's drop counter ride along with every frame
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0
+        || setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) < 0
+        || bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        fprintf(stderr, "Error: SocketCAN %s: %s\n", interface, strerror(errno));
+        close();
+        return false;
+    }
+
+    rxHead = rxCount = txCount = 0;
+    return true;
+}
+
+void SocketCANBackend::close() {
+    if (fd < 0) return;
+    flush();
+    ::close(fd);
+    fd = -1;
+}
+
+bool SocketCANBackend::setFilter(uint8_t sets) {
+    if (fd < 0) return false;
+
+    // Exact match on a standard ID; the flag bits in the mask keep out extended and RTR frames
+    const canid_t exact = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+    std::vector<struct can_filter> filters;
+    if (sets == FILTER_ALL) {
+        filters.push_back({0, 0});
+    }
+    if (sets & FILTER_INVERTER) {
+        for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+            const CanMessage* first = BDRCANLib::getSlotMessages(slot)[0];
+            if (BDRCANLib::isInverterMessage(first)) filters.push_back({first->id, exact});
+        }
+    }
+    if (sets & FILTER_BMS) {
+        filters.push_back({BDRCANIsoTp::RESPONSE_ID, exact});
+    }
+
+    if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+                   (socklen_t)(filters.size() * sizeof(struct can_filter))) < 0) {
+        fprintf(stderr, "Error: SocketCAN filter: %s\n", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool SocketCANBackend::send(const CANMessage& frame) {
+    if (fd < 0) return false;
+    // A partial flush still frees slots; reject only while the batch stays full
+    if (txCount == BATCH) flush();
+    if (txCount == BATCH) {
+        stats.rejected++;
+        return false;
+    }
+
+    struct can_frame& out = txFrames[txCount++];
+    memset(&out, 0, sizeof(out));
+    out.can_id = frame.ext ? ((frame.id & CAN_EFF_MASK) | CAN_EFF_FLAG) : (frame.id & CAN_SFF_MASK);
+    if (frame.rtr) out.can_id |= CAN_RTR_FLAG;
+    out.can_dlc = (frame.len > 8) ? 8 : frame.len;
+    memcpy(out.data, frame.data, 8);
+
+    if (txCount == BATCH) flush();
+    return true;
+}
+
+bool SocketCANBackend::flush() {
+    if (fd < 0 || txCount == 0) return txCount == 0;
+
+    for (int i = 0; i < txCount; i++) {
+        memset(&txMessages[i], 0, sizeof(txMessages[i]));
+        txMessages[i].msg_hdr.msg_iov = &txVectors[i];
+        txMessages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = sendmmsg(fd, txMessages, txCount, MSG_DONTWAIT);
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            // Interface queue full, the same as full mailboxes: keep the frames for the next flush
+            stats.sendBusy++;
+            return false;
+        }
+        fprintf(stderr, "Error: SocketCAN send: %s\n", strerror(errno));
+        stats.errors++;
+        txCount = 0;
+        return true;
+    }
+
+    stats.sent += sent;
+    stats.sendCalls++;
+    if (sent < txCount) {
+        stats.sendBusy++;
+        memmove(&txFrames[0], &txFrames[sent], (txCount - sent) * sizeof(struct can_frame));
+    }
+    txCount -= sent;
+    return txCount == 0;
+}
+
+bool SocketCANBackend::fill() {
+    for (int i = 0; i < BATCH; i++) {
+        memset(&rxMessages[i], 0, sizeof(rxMessages[i]));
+        rxMessages[i].msg_hdr.msg_iov = &rxVectors[i];
+        rxMessages[i].msg_hdr.msg_iovlen = 1;
+        rxMessages[i].msg_hdr.msg_control = rxControl[i];
+        rxMessages[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+
+    int count = recvmmsg(fd, rxMessages, BATCH, MSG_DONTWAIT, nullptr);
+    if (count <= 0) {
+        if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            fprintf(stderr, "Error: SocketCAN receive: %s\n", strerror(errno));
+            stats.errors++;
+        }
+        return false;
+    }
+    stats.receiveCalls++;
+
+    // Frames arrive in place; compact out anything that is not a whole classic CAN frame
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (rxMessages[i].msg_len != sizeof(struct can_frame)) continue;
+
+        uint64_t timestampNs = 0;
+        for (struct cmsghdr* c = CMSG_FIRSTHDR(&rxMessages[i].msg_hdr); c != nullptr;
+             c = CMSG_NXTHDR(&rxMessages[i].msg_hdr, c)) {
+            if (c->cmsg_level != SOL_SOCKET) continue;
+            if (c->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                timestampNs = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+            } else if (c->cmsg_type == SO_RXQ_OVFL) {
+                // Running total for the socket
+                memcpy(&stats.kernelDrops, CMSG_DATA(c), sizeof(uint32_t));
+            }
+        }
+
+        if (kept != i) rxFrames[kept] = rxFrames[i];
+        rxTimestamps[kept] = timestampNs;
+        kept++;
+    }
+    rxHead = 0;
+    rxCount = kept;
+    return kept > 0;
+}
+
+bool SocketCANBackend::receive(CANMessage& frame) {
+    uint64_t timestampNs;
+    return receive(frame, timestampNs);
+}
+
+bool SocketCANBackend::receive(CANMessage& frame, uint64_t& timestampNs) {
+    if (fd < 0) return false;
+    flush();
+    if (rxCount == 0 && !fill()) return false;
+
+    const struct can_frame& in = rxFrames[rxHead];
+    frame.ext = (in.can_id & CAN_EFF_FLAG) != 0;
+    frame.rtr = (in.can_id & CAN_RTR_FLAG) != 0;
+    frame.id = in.can_id & (frame.ext ? CAN_EFF_MASK : CAN_SFF_MASK);
+    frame.idx = 0;
+    frame.len = (in.can_dlc > 8) ? 8 : in.can_dlc;
+    memcpy(frame.data, in.data, 8);
+    timestampNs = rxTimestamps[rxHead];
+
+    rxHead++;
+    rxCount--;
+    stats.received++;
+    return true;
+}
+
+bool SocketCANBackend::available() {
+    if (fd < 0) return false;
+    flush();
+    return rxCount > 0 || fill();
+}
+
+bool SocketCANBackend::wait(int timeoutMs) {
+    if (fd < 0) return false;
+    if (available()) return true;
+
+    struct pollfd p;
+    p.fd = fd;
+    p.events = POLLIN;
+    p.revents = 0;
+    if (poll(&p, 1, timeoutMs) <= 0) return false;
+    return available();
+}
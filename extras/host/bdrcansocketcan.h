@@ -0,0 +1,98 @@
+/*
+    bdrcansocketcan.h - SocketCAN backend for the host ACAN_T4, for Linux gateways and vcan.
+
+    Attach it with ACAN_T4::can1.setBackend(&socket) and the scheduler, ISO-TP receiver and
+    decoders run unchanged on a Linux computer in the car, or against a virtual vcan
+    interface on a developer box. Frames are moved in batches with recvmmsg / sendmmsg,
+    every received frame carries the kernel's receive timestamp, and the kernel drops IDs
+    the signal table does not know before they reach the process.
+
+    Sends are batched: a frame accepted by send() goes to the kernel at the next flush(),
+    which receive(), available() and wait() call, or as soon as a whole batch is queued.
+    */
+
+    #ifndef bdrcansocketcan_h
+    #define bdrcansocketcan_h
+    #include <ACAN_T4.h>
+    #include <linux/can.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <time.h>
+
+    struct SocketCANStats {
+        uint64_t received;          // frames returned by receive()
+        uint64_t sent;              // frames the kernel accepted
+        uint64_t receiveCalls;      // recvmmsg calls that returned frames
+        uint64_t sendCalls;         // sendmmsg calls that sent frames
+        uint32_t kernelDrops;       // frames the socket queue dropped (SO_RXQ_OVFL)
+        uint32_t sendBusy;          // flushes cut short by a full interface queue (retried)
+        uint32_t rejected;          // send() refused, batch still full after a flush
+        uint32_t errors;            // other socket errors; the frames involved are lost
+    };
+
+    class SocketCANBackend : public CANBackend {
+    public:
+        SocketCANBackend();
+        ~SocketCANBackend();
+
+        // Bind a raw CAN socket to an interface ("can0", "vcan0"); errors go to stderr
+        bool open(const char* interface);
+        void close();
+        bool isOpen() const { return fd >= 0; }
+
+        // Receive only the IDs of these signal table groups (FILTER_* bits); FILTER_ALL
+        // receives everything. BMS answers arrive on the ISO-TP response ID, not on the PIDs.
+        enum FilterSet : uint8_t {
+            FILTER_ALL = 0x00,
+            FILTER_INVERTER = 0x01,
+            FILTER_BMS = 0x02
+        };
+        bool setFilter(uint8_t sets);
+
+        // CANBackend
+        bool send(const CANMessage& frame) override;
+        bool receive(CANMessage& frame) override;
+        bool available() override;
+
+        // receive(), plus the kernel receive time (CLOCK_REALTIME, nanoseconds)
+        bool receive(CANMessage& frame, uint64_t& timestampNs);
+
+        // Hand queued sends to the kernel; false if some are still queued
+        bool flush();
+
+        // Block until a frame can be received, up to timeoutMs (-1 waits forever)
+        bool wait(int timeoutMs);
+
+        int getFd() const { return fd; }
+        const SocketCANStats& getStats() const { return stats; }
+
+        static const int BATCH = 32;
+
+    private:
+        SocketCANBackend(const SocketCANBackend&) = delete;
+        SocketCANBackend& operator=(const SocketCANBackend&) = delete;
+
+        bool fill();
+
+        // Room for the receive timestamp and the drop counter of one frame
+        static const size_t CONTROL_SIZE = CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t));
+
+        int fd = -1;
+
+        struct can_frame rxFrames[BATCH];
+        struct iovec rxVectors[BATCH];
+        struct mmsghdr rxMessages[BATCH];
+        uint8_t rxControl[BATCH][CONTROL_SIZE];
+        uint64_t rxTimestamps[BATCH];
+        int rxHead = 0;
+        int rxCount = 0;
+
+        struct can_frame txFrames[BATCH];
+        struct iovec txVectors[BATCH];
+        struct mmsghdr txMessages[BATCH];
+        int txCount = 0;
+
+        SocketCANStats stats;
+    };
+
+#endif
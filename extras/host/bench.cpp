@@ -0,0 +1,470 @@
+/*
+    bench.cpp - bdrcan-bench: throughput of the decode entry points on the host.
+
+    batch   decodes the same random full-DLC frames (bus or uniform ID mix) into per-signal columns
+            three ways: getSlotMessages + an interpreter per signal, decodeFrame per frame, and
+            decodeBatch, for batches of 64 to 4096 frames. The columns are compared so a faster
+            path that decodes differently is reported as a mismatch.
+    cells   unpacks random big-endian 16-bit cell samples (cell_voltages_*) with interpretBMSArray
+            in 12-cell payloads, then with the bdrcansimd.h kernels at every instruction set the
+            CPU supports, into floats and into raw integers. Every output is compared with the
+            scalar kernel and with interpretBMSArray. Needs BDRCAN_BMS_CELLS.
+    latency injects throttle_signal / brake_signal frames into a HostLoopback bus behind a burst
+            of BMS responses (0 to 48 frames), runs the receive loop of a reference node
+            (receive, BDRCANDispatcher, a torque handler that encodes Set_AC_Current into a
+            BDRCANTxQueue) and times each injection until the command reaches tryToSend. Needs
+            BDRCAN_INVERTER_COMMANDS and BDRCAN_INVERTER_FEEDBACK; without the BMS groups the
+            burst is made of the other inverter broadcasts.
+    */
+
+#include "Arduino.h"
+#include "bdrcanlib.h"
+#include "bdrcansimd.h"
+#include "bdrcandispatch.h"
+#include "bdrcantxqueue.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int BATCH_SIZES[] = { 64, 256, 1024, 4096 };
+
+struct Columns {
+    std::vector<std::vector<float> > values;
+    std::vector<std::vector<uint32_t> > frames;
+    std::vector<SignalColumn> columns;
+
+    explicit Columns(int capacity)
+        : values(BDRCANLib::MESSAGE_COUNT, std::vector<float>(capacity)),
+          frames(BDRCANLib::MESSAGE_COUNT, std::vector<uint32_t>(capacity)),
+          columns(BDRCANLib::MESSAGE_COUNT) {
+        for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+            columns[i].values = values[i].data();
+            columns[i].frames = frames[i].data();
+            columns[i].capacity = capacity;
+            columns[i].count = 0;
+        }
+    }
+
+    void clear() {
+        for (SignalColumn& column : columns) column.count = 0;
+    }
+
+    // Appends like decodeBatch, for the per-frame paths
+    void push(int signal, float value, uint32_t frame) {
+        SignalColumn& column = columns[signal];
+        if (column.count >= column.capacity) return;
+        column.values[column.count] = value;
+        column.frames[column.count] = frame;
+        column.count++;
+    }
+
+    bool operator==(const Columns& other) const {
+        for (int i = 0; i < BDRCANLib::MESSAGE_COUNT; i++) {
+            const SignalColumn& a = columns[i];
+            const SignalColumn& b = other.columns[i];
+            if (a.count != b.count) return false;
+            if (memcmp(a.values, b.values, a.count * sizeof(float)) != 0) return false;
+            if (memcmp(a.frames, b.frames, a.count * sizeof(uint32_t)) != 0) return false;
+        }
+        return true;
+    }
+};
+
+// uniform: every known ID equally often. bus: inverter broadcasts round-robin (the bulk of the
+// traffic on the car), with a random BMS response every eighth frame.
+static std::vector<messageStruct> randomFrames(size_t count, const std::string& mix, uint32_t seed) {
+    std::vector<uint32_t> broadcast, responses;
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        const CanMessage* definition = BDRCANLib::getSlotMessages(slot)[0];
+        if (mix == "bus" && BDRCANLib::isInverterMessage(definition) && definition->id >= 0x20) {
+            broadcast.push_back(definition->id);
+        } else {
+            responses.push_back(definition->id);
+        }
+    }
+
+    std::mt19937 random(seed);
+    std::vector<messageStruct> frames(count);
+    size_t next = 0;
+    for (size_t f = 0; f < count; f++) {
+        messageStruct& msg = frames[f];
+        if (!broadcast.empty() && (responses.empty() || f % 8 != 7)) {
+            msg.id = broadcast[next++ % broadcast.size()];
+        } else {
+            msg.id = responses[random() % responses.size()];
+        }
+        msg.length = 8;
+        for (int i = 0; i < 8; i++) msg.data[i] = (uint8_t)random();
+    }
+    return frames;
+}
+
+static void decodeInterpret(BDRCANLib& lib, const messageStruct* frames, int n, Columns& out) {
+    const CanMessage* const* all = BDRCANLib::getAllMessages();
+    for (int f = 0; f < n; f++) {
+        const messageStruct& msg = frames[f];
+        int count;
+        const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(msg.id), &count);
+        for (int i = 0; i < count; i++) {
+            float value = BDRCANLib::isBMSMessage(defs[i]) ? lib.interpretBMSMessage(msg, *defs[i])
+                                                           : lib.interpretInverterMessage(msg, *defs[i]);
+            out.push((int)(defs - all) + i, value, f);
+        }
+    }
+}
+
+static void decodePerFrame(BDRCANLib& lib, const messageStruct* frames, int n, Columns& out) {
+    const CanMessage* const* all = BDRCANLib::getAllMessages();
+    float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+    for (int f = 0; f < n; f++) {
+        int count = lib.decodeFrame(frames[f], values, BDRCANLib::MAX_SIGNALS_PER_ID);
+        if (count == 0) continue;
+        int first = (int)(BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(frames[f].id)) - all);
+        for (int i = 0; i < count; i++) out.push(first + i, values[i], f);
+    }
+}
+
+static void decodeBatched(BDRCANLib& lib, const messageStruct* frames, int n, Columns& out) {
+    lib.decodeBatch(frames, n, out.columns.data());
+}
+
+typedef std::function<void(BDRCANLib&, const messageStruct*, int, Columns&)> DecodePath;
+
+// Frames per second over every batch of the pool: the best of REPEATS runs of at least
+// minSeconds each, so a descheduled run does not decide the result
+static const int REPEATS = 5;
+
+static double measure(const DecodePath& path, const std::vector<messageStruct>& pool, int batch, double minSeconds) {
+    BDRCANLib lib;
+    Columns out(batch);
+    double best = 0;
+
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        size_t frames = 0;
+        double seconds = 0;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            for (size_t base = 0; base + batch <= pool.size(); base += batch) {
+                out.clear();
+                path(lib, &pool[base], batch, out);
+            }
+            frames += pool.size() / batch * batch;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < minSeconds);
+        if (frames / seconds > best) best = frames / seconds;
+    }
+    return best;
+}
+
+static bool sameColumns(const std::vector<messageStruct>& pool, int batch) {
+    BDRCANLib lib;
+    Columns a(batch), b(batch), c(batch);
+    for (size_t base = 0; base + batch <= pool.size(); base += batch) {
+        a.clear();
+        b.clear();
+        c.clear();
+        decodeInterpret(lib, &pool[base], batch, a);
+        decodePerFrame(lib, &pool[base], batch, b);
+        decodeBatched(lib, &pool[base], batch, c);
+        if (!(a == b) || !(a == c)) return false;
+    }
+    return true;
+}
+
+static int runBatch(size_t poolFrames, const std::string& mix, double minSeconds) {
+    std::vector<messageStruct> pool = randomFrames(poolFrames, mix, 1);
+    printf("%d signals, %d IDs, %zu random frames (%s mix), full DLC\n",
+           BDRCANLib::MESSAGE_COUNT, BDRCANLib::getSlotCount(), pool.size(), mix.c_str());
+    printf("%6s %14s %14s %14s %9s %6s\n", "batch", "interpret/s", "decodeFrame/s", "decodeBatch/s", "speedup", "match");
+
+    bool allMatch = true;
+    for (int batch : BATCH_SIZES) {
+        double interpret = measure(decodeInterpret, pool, batch, minSeconds);
+        double perFrame = measure(decodePerFrame, pool, batch, minSeconds);
+        double batched = measure(decodeBatched, pool, batch, minSeconds);
+        bool match = sameColumns(pool, batch);
+        allMatch = allMatch && match;
+        printf("%6d %14.0f %14.0f %14.0f %8.2fx %6s\n", batch, interpret, perFrame, batched,
+               batched / perFrame, match ? "yes" : "NO");
+    }
+    return allMatch ? 0 : 1;
+}
+
+#if BDRCAN_BMS_CELLS
+// Cells per second of fn over samples, best of REPEATS runs of at least minSeconds each
+static double measureCells(const std::function<void()>& fn, size_t samples, double minSeconds) {
+    double best = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        size_t cells = 0;
+        double seconds = 0;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            fn();
+            cells += samples;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < minSeconds);
+        if (cells / seconds > best) best = cells / seconds;
+    }
+    return best;
+}
+
+static int runCells(size_t samples, double minSeconds) {
+    const CanMessage& definition = cell_voltages_1_12;
+    const size_t payloadCells = 12;
+    samples -= samples % payloadCells;
+
+    std::mt19937 random(1);
+    std::vector<uint8_t> data(samples * 2);
+    for (uint8_t& byte : data) byte = (uint8_t)random();
+
+    // Reference: the library's byte loop, one 12-cell response at a time
+    BDRCANLib lib;
+    std::vector<float> reference(samples);
+    auto interpret = [&]() {
+        for (size_t i = 0; i < samples; i += payloadCells) {
+            lib.interpretBMSArray(&data[i * 2], payloadCells * 2, definition, &reference[i], payloadCells);
+        }
+    };
+    interpret();
+
+    printf("%zu cells (%s, 16-bit big-endian), best level: %s\n",
+           samples, definition.name, simdLevelName(simdDetect()));
+    printf("%-18s %14s %14s %6s\n", "path", "float cells/s", "int cells/s", "match");
+    printf("%-18s %14.0f %14s %6s\n", "interpretBMSArray", measureCells(interpret, samples, minSeconds), "-", "-");
+
+    std::vector<float> values(samples);
+    std::vector<int32_t> raw(samples), scalarRaw(samples);
+    bool allMatch = true;
+    for (int level = SIMD_SCALAR; level <= simdDetect(); level++) {
+        simdSetLevel((SimdLevel)level);
+        auto scaled = [&]() { decodeBMSArray(data.data(), data.size(), definition, values.data(), samples); };
+        auto unpacked = [&]() { unpackBigEndian16(data.data(), samples, false, raw.data()); };
+        double floatRate = measureCells(scaled, samples, minSeconds);
+        double intRate = measureCells(unpacked, samples, minSeconds);
+
+        scaled();
+        unpacked();
+        if (level == SIMD_SCALAR) scalarRaw = raw;
+        bool match = memcmp(values.data(), reference.data(), samples * sizeof(float)) == 0 && raw == scalarRaw;
+        allMatch = allMatch && match;
+        printf("%-18s %14.0f %14.0f %6s\n", simdLevelName((SimdLevel)level), floatRate, intRate, match ? "yes" : "NO");
+    }
+    simdSetLevel(simdDetect());
+    return allMatch ? 0 : 1;
+}
+#endif
+
+#if BDRCAN_INVERTER_COMMANDS && BDRCAN_INVERTER_FEEDBACK
+// Background BMS responses queued ahead of each throttle / brake frame; the echo of the command
+// also passes through the ring, so the largest burst leaves room for two frames
+static const int BACKGROUND_FRAMES[] = { 0, 4, 16, 32, 48 };
+static_assert(48 + 2 <= HostLoopback::CAPACITY, "burst does not fit the loopback ring");
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+// HostLoopback that notes when the command frame is handed to the controller
+class CaptureLoopback : public HostLoopback {
+public:
+    bool send(const CANMessage& frame) override {
+        bool ok = HostLoopback::send(frame);
+        if (ok && frame.id == Set_AC_Current.id) {
+            sentAt = std::chrono::steady_clock::now();
+            captured++;
+        }
+        return ok;
+    }
+
+    TimePoint sentAt;
+    uint32_t captured = 0;
+};
+
+// Reference control node: pedal signals in, one Set_AC_Current out per pedal frame
+struct TorqueNode {
+    static constexpr float MAX_AC_CURRENT = 300.0f;     // A_pk at 100 % throttle
+
+    BDRCANDispatcher dispatcher;
+    BDRCANTxQueue tx;
+    float throttle = 0;
+    float brake = 0;
+    uint32_t bmsFrames = 0;
+
+    explicit TorqueNode(ACAN_T4& bus) : tx(bus) {
+        dispatcher.onSignal(throttle_signal, onPedal, this);
+        dispatcher.onSignal(brake_signal, onPedal, this);
+        dispatcher.onDevice(BDRCANDispatcher::DEVICE_BMS, onBMS, this);
+    }
+
+    static void onPedal(const CanMessage& definition, float value, void* context) {
+        TorqueNode* node = (TorqueNode*)context;
+        if (&definition == &throttle_signal) {
+            node->throttle = value;
+        } else {
+            node->brake = value;
+        }
+        // Brake overrides throttle
+        float current = (node->brake > 0 ? -node->brake : node->throttle) * MAX_AC_CURRENT / 100.0f;
+        CANMessage frame;
+        frame.id = Set_AC_Current.id;
+        frame.len = 2;
+        BDRCANLib::encodeInverterValue(current, Set_AC_Current, frame.data);
+        node->tx.send(frame, TX_SAFETY, 0);
+    }
+
+    static void onBMS(const messageStruct&, const DecodedFrame&, void* context) {
+        ((TorqueNode*)context)->bmsFrames++;
+    }
+
+    // One pass of loop(): drain the receive queue, then the transmit queue
+    void poll(ACAN_T4& bus) {
+        CANMessage frame;
+        while (bus.receive(frame)) {
+            messageStruct msg;
+            msg.id = frame.id;
+            msg.length = frame.len;
+            memcpy(msg.data, frame.data, sizeof(msg.data));
+            dispatcher.dispatch(msg);
+        }
+        tx.update(0);
+    }
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static int runLatency(size_t samples) {
+    std::vector<uint32_t> backgroundIDs;
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        const CanMessage* definition = BDRCANLib::getSlotMessages(slot)[0];
+        if (BDRCANLib::isBMSMessage(definition)) backgroundIDs.push_back(definition->id);
+    }
+    // Without the BMS groups the background is the other inverter broadcasts
+    bool noBMS = backgroundIDs.empty();
+    for (int slot = 0; noBMS && slot < BDRCANLib::getSlotCount(); slot++) {
+        const CanMessage* definition = BDRCANLib::getSlotMessages(slot)[0];
+        if (definition->id != throttle_signal.id && definition->id != brake_signal.id
+            && definition->id != Set_AC_Current.id) {
+            backgroundIDs.push_back(definition->id);
+        }
+    }
+
+    CaptureLoopback loopback;
+    ACAN_T4& bus = ACAN_T4::can1;
+    bus.setBackend(&loopback);
+    TorqueNode node(bus);
+    std::mt19937 random(1);
+
+    printf("%zu pedal frames per row, %zu background IDs, receive -> dispatch -> encode -> TX_SAFETY -> tryToSend\n",
+           samples, backgroundIDs.size());
+    printf("%10s %10s %10s %10s %10s %10s\n", "background", "frames/s", "p50 ns", "p99 ns", "max ns", "commands");
+
+    bool allSent = true;
+    for (int background : BACKGROUND_FRAMES) {
+        std::vector<double> latencies;
+        latencies.reserve(samples);
+        uint32_t capturedBefore = loopback.captured;
+
+        for (size_t i = 0; i < samples + samples / 16; i++) {
+            for (int b = 0; b < background; b++) {
+                CANMessage frame;
+                frame.id = backgroundIDs[random() % backgroundIDs.size()];
+                frame.len = 8;
+                frame.data64 = ((uint64_t)random() << 32) | random();
+                bus.tryToSend(frame);
+            }
+
+            // Alternate throttle and brake; every other brake frame is a release (0 %), which
+            // hands the command back to the throttle
+            CANMessage pedal;
+            pedal.id = (i & 1) ? brake_signal.id : throttle_signal.id;
+            pedal.len = 8;
+            pedal.data16[0] = ((i & 3) == 1) ? 0 : (uint16_t)(random() % 1001);
+            bus.tryToSend(pedal);
+            TimePoint injected = std::chrono::steady_clock::now();
+
+            node.poll(bus);
+
+            // The first sixteenth warms caches and branch predictors and is not recorded
+            if (i >= samples / 16) {
+                latencies.push_back(std::chrono::duration<double, std::nano>(loopback.sentAt - injected).count());
+            }
+        }
+
+        uint32_t commands = loopback.captured - capturedBefore;
+        allSent = allSent && commands == samples + samples / 16;
+        std::sort(latencies.begin(), latencies.end());
+        double totalNs = 0;
+        for (double ns : latencies) totalNs += ns;
+        printf("%10d %10.0f %10.0f %10.0f %10.0f %10u\n", background,
+               (background + 1) * samples / (totalNs / 1e9),
+               percentile(latencies, 0.50), percentile(latencies, 0.99), latencies.back(), commands);
+    }
+
+    bus.setBackend(nullptr);
+    return allSent ? 0 : 1;
+}
+#endif
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-bench batch [-m uniform|bus] [-n frames] [-t seconds]\n"
+            "       bdrcan-bench cells [-n cells] [-t seconds]\n"
+            "       bdrcan-bench latency [-n samples]\n"
+            "  -m  ID mix: every ID equally often, or inverter broadcasts plus BMS responses (default bus)\n"
+            "  -n  random frames / cells / pedal frames per background load (default 65536)\n"
+            "  -t  minimum time per measurement, best of 5 (default 0.1)\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    std::string mode = argv[1];
+    size_t poolFrames = 65536;
+    double minSeconds = 0.1;
+    std::string mix = "bus";
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-m" && i + 1 < argc) {
+            mix = argv[++i];
+        } else if (arg == "-n" && i + 1 < argc) {
+            poolFrames = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "-t" && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (poolFrames < 4096) poolFrames = 4096;
+    if (mix != "uniform" && mix != "bus") {
+        usage();
+        return 2;
+    }
+
+    if (mode == "batch") return runBatch(poolFrames, mix, minSeconds);
+#if BDRCAN_BMS_CELLS
+    if (mode == "cells") return runCells(poolFrames, minSeconds);
+#else
+    if (mode == "cells") {
+        fprintf(stderr, "bdrcan-bench: cells needs BDRCAN_BMS_CELLS (see bdrcanconfig.h)\n");
+        return 2;
+    }
+#endif
+#if BDRCAN_INVERTER_COMMANDS && BDRCAN_INVERTER_FEEDBACK
+    if (mode == "latency") return runLatency(poolFrames);
+#else
+    if (mode == "latency") {
+        fprintf(stderr, "bdrcan-bench: latency needs BDRCAN_INVERTER_COMMANDS and BDRCAN_INVERTER_FEEDBACK\n");
+        return 2;
+    }
+#endif
+    usage();
+    return 2;
+}
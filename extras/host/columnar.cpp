@@ -0,0 +1,144 @@
+/*
+    columnar.cpp - bdrcan-columnar: convert logs to .bdrcol and query single channels.
+
+      bdrcan-columnar write <log> <out.bdrcol> [-b rows]
+      bdrcan-columnar list <file.bdrcol>
+      bdrcan-columnar read <file.bdrcol> <signal> [--from us] [--to us] [--raw]
+    */
+
+#include "Arduino.h"
+#include "bdrcancolumn.h"
+#include "bdrcanlog.h"
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-columnar write <log> <out.bdrcol> [-b rows]\n"
+            "       bdrcan-columnar list <file.bdrcol>\n"
+            "       bdrcan-columnar read <file.bdrcol> <signal> [--from us] [--to us] [--raw]\n"
+            "  <signal> is a signal name, its alternative name, or 0xID for single-signal IDs\n");
+}
+
+static int writeColumns(const char* logPath, const char* outPath, uint32_t blockRows) {
+    LogFile log;
+    if (!log.open(logPath)) {
+        fprintf(stderr, "bdrcan-columnar: cannot read %s\n", logPath);
+        return 1;
+    }
+
+    ColumnWriter writer;
+    if (!writer.open(outPath, blockRows)) {
+        fprintf(stderr, "bdrcan-columnar: cannot write %s\n", outPath);
+        return 1;
+    }
+
+    // One chunk over the whole log keeps the rows in file order
+    LogChunk all = {log.dataStart(), log.size()};
+    size_t cursor = all.begin;
+    LogRecord record;
+    messageStruct msg;
+    uint64_t frames = 0;
+    while (log.next(all, cursor, record)) {
+        // The table holds standard IDs only; an extended 0x20 is not ERPM
+        if (record.flags & LOG_FLAG_EXTENDED) continue;
+        msg.id = record.id;
+        msg.length = (record.length > 8) ? 8 : record.length;
+        memcpy(msg.data, record.data, 8);
+        writer.addFrame(record.timestampUs, msg);
+        frames++;
+    }
+
+    if (!writer.close()) {
+        fprintf(stderr, "bdrcan-columnar: write failed\n");
+        return 1;
+    }
+    fprintf(stderr, "%llu frames\n", (unsigned long long)frames);
+    return 0;
+}
+
+static int listColumns(const char* path) {
+    ColumnReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "bdrcan-columnar: cannot read %s\n", path);
+        return 1;
+    }
+
+    printf("index,id,signal,units,rows,blocks,bytes\n");
+    for (int i = 0; i < reader.columnCount(); i++) {
+        const ColumnInfo& column = reader.column(i);
+        if (column.rows == 0) continue;
+        uint64_t bytes = 0;
+        for (const ColumnBlock& block : column.blocks) bytes += block.bytes;
+        printf("%u,0x%X,%s,%s,%llu,%zu,%llu\n", column.index, column.id, column.name.c_str(),
+               column.units.c_str(), (unsigned long long)column.rows, column.blocks.size(),
+               (unsigned long long)bytes);
+    }
+    return 0;
+}
+
+static int readColumn(const char* path, const char* signal, uint64_t fromUs, uint64_t toUs, bool raw) {
+    ColumnReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "bdrcan-columnar: cannot read %s\n", path);
+        return 1;
+    }
+
+    int index = reader.findColumn(signal);
+    if (index < 0) {
+        fprintf(stderr, "bdrcan-columnar: no single column named %s\n", signal);
+        return 1;
+    }
+
+    std::vector<uint64_t> timestamps;
+    std::vector<int64_t> rawValues;
+    std::vector<float> values;
+    if (!reader.read(index, fromUs, toUs, timestamps, &rawValues, &values)) {
+        fprintf(stderr, "bdrcan-columnar: corrupt block in %s\n", path);
+        return 1;
+    }
+
+    const ColumnInfo& column = reader.column(index);
+    printf("timestamp_us,%s%s%s\n", column.name.c_str(), column.units.empty() ? "" : " ",
+           column.units.c_str());
+    for (size_t i = 0; i < timestamps.size(); i++) {
+        if (raw) printf("%llu,%lld\n", (unsigned long long)timestamps[i], (long long)rawValues[i]);
+        else printf("%llu,%.9g\n", (unsigned long long)timestamps[i], (double)values[i]);
+    }
+    fprintf(stderr, "%zu rows, %llu block bytes read\n", timestamps.size(),
+            (unsigned long long)reader.blockBytesRead());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    std::string command = argv[1];
+
+    if (command == "write" && argc >= 4) {
+        uint32_t blockRows = ColumnWriter::DEFAULT_BLOCK_ROWS;
+        for (int i = 4; i + 1 < argc; i += 2) {
+            if (std::string(argv[i]) == "-b") blockRows = (uint32_t)atol(argv[i + 1]);
+        }
+        return writeColumns(argv[2], argv[3], blockRows);
+    }
+
+    if (command == "list") return listColumns(argv[2]);
+
+    if (command == "read" && argc >= 4) {
+        uint64_t fromUs = 0;
+        uint64_t toUs = UINT64_MAX;
+        bool raw = false;
+        for (int i = 4; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--from" && i + 1 < argc) fromUs = strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--to" && i + 1 < argc) toUs = strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--raw") raw = true;
+        }
+        return readColumn(argv[2], argv[3], fromUs, toUs, raw);
+    }
+
+    usage();
+    return 2;
+}
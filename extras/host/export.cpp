@@ -0,0 +1,215 @@
+/*
+    export.cpp - bdrcan-export: decode a log to CSV or NDJSON for people without the tools.
+
+    Every decoded value goes out as its own row by default; -s turns the log into snapshots
+    of the latest value of each signal at a fixed interval, one column per signal. Output is
+    formatted by ExportWriter into one reusable buffer and written in large blocks.
+    --printf formats the default CSV rows with snprintf per value instead, for comparison.
+    */
+
+#include "Arduino.h"
+#include "bdrcanexport.h"
+#include "bdrcanlib.h"
+#include "bdrcanlog.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-export [options] <log>\n"
+            "  -f csv|ndjson  output format (default csv)\n"
+            "  -o <file>      write here instead of stdout; - is stdout\n"
+            "  -s <ms>        snapshot rows every <ms> of log time, one column per signal\n"
+            "  -c <signal>    snapshot column, by name or alt name (repeat; default every signal)\n"
+            "  -b <KiB>       output buffer (default 4096)\n"
+            "  -n             format only, write nothing (throughput of the formatting)\n"
+            "  --printf       CSV rows through snprintf per value, for comparison\n");
+}
+
+static int findSignal(const char* name) {
+    const CanMessage* msg = BDRCANLib::findMessageByName(name);
+    if (msg == nullptr) msg = BDRCANLib::findMessageByAlt(name);
+    return (msg == nullptr) ? -1 : BDRCANLib::findMessageIndex(msg);
+}
+
+// The row-per-value CSV as a printf loop would write it
+static uint64_t exportPrintf(const LogFile& log, FILE* output, uint64_t& frames, uint64_t& rows) {
+    BDRCANLib lib;
+    LogChunk all = {log.dataStart(), log.size()};
+    size_t cursor = all.begin;
+    LogRecord record;
+    messageStruct msg;
+    float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+    uint64_t bytes = 0;
+
+    bytes += fprintf(output, "timestamp_us,id,signal,units,value\n");
+    while (log.next(all, cursor, record)) {
+        frames++;
+        // The table holds standard IDs only; an extended 0x20 is not ERPM
+        if (record.flags & LOG_FLAG_EXTENDED) continue;
+        msg.id = record.id;
+        msg.length = (record.length > 8) ? 8 : record.length;
+        memcpy(msg.data, record.data, 8);
+
+        // count stops at the DLC: a short frame gives rows only for the fields it carries
+        int count = lib.decodeFrame(msg, values, BDRCANLib::MAX_SIGNALS_PER_ID);
+        const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(msg.id));
+        for (int i = 0; i < count; i++) {
+            bytes += fprintf(output, "%llu,0x%lX,%s,%s,%.9g\n", (unsigned long long)record.timestampUs,
+                             (unsigned long)msg.id, defs[i]->name, defs[i]->units, (double)values[i]);
+        }
+        rows += count;
+    }
+    return bytes;
+}
+
+int main(int argc, char** argv) {
+    ExportFormat format = EXPORT_CSV;
+    const char* outputPath = nullptr;
+    const char* logPath = nullptr;
+    uint64_t snapshotUs = 0;
+    size_t bufferBytes = ExportWriter::DEFAULT_BUFFER;
+    std::vector<int> columns;
+    bool discard = false;
+    bool printfRows = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-f" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "csv") format = EXPORT_CSV;
+            else if (name == "ndjson" || name == "json") format = EXPORT_NDJSON;
+            else {
+                usage();
+                return 2;
+            }
+        } else if (arg == "-o" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "-s" && hasValue) {
+            snapshotUs = (uint64_t)(atof(argv[++i]) * 1000);
+        } else if (arg == "-c" && hasValue) {
+            int index = findSignal(argv[++i]);
+            if (index < 0) {
+                fprintf(stderr, "bdrcan-export: unknown signal %s\n", argv[i]);
+                return 2;
+            }
+            columns.push_back(index);
+        } else if (arg == "-b" && hasValue) {
+            bufferBytes = (size_t)atol(argv[++i]) * 1024;
+        } else if (arg == "-n") {
+            discard = true;
+        } else if (arg == "--printf") {
+            printfRows = true;
+        } else if (arg[0] != '-' && logPath == nullptr) {
+            logPath = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (logPath == nullptr || (printfRows && (format != EXPORT_CSV || snapshotUs > 0))) {
+        usage();
+        return 2;
+    }
+
+    // Short frames are expected in logs
+    Serial.setEnabled(false);
+
+    LogFile log;
+    if (!log.open(logPath)) {
+        fprintf(stderr, "bdrcan-export: cannot read %s\n", logPath);
+        return 1;
+    }
+
+    uint64_t frames = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    uint64_t writes = 0;
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+
+    if (printfRows) {
+        FILE* output = discard ? fopen("/dev/null", "wb")
+                     : (outputPath != nullptr && strcmp(outputPath, "-") != 0) ? fopen(outputPath, "wb") : stdout;
+        if (output == nullptr) {
+            fprintf(stderr, "bdrcan-export: cannot write %s\n", outputPath);
+            return 1;
+        }
+        bytes = exportPrintf(log, output, frames, rows);
+        ok = fflush(output) == 0;
+        if (output != stdout) ok &= fclose(output) == 0;
+    } else {
+        ExportWriter writer(format, bufferBytes);
+        if (!columns.empty()) writer.setColumns(columns);
+        if (!discard && !writer.open(outputPath)) return 1;
+
+        BDRCANLib lib;
+        LogChunk all = {log.dataStart(), log.size()};
+        size_t cursor = all.begin;
+        LogRecord record;
+        messageStruct msg;
+        float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+
+        // Snapshot state: latest value of every signal, as of the snapshot time
+        float latest[BDRCANLib::MESSAGE_COUNT] = {};
+        bool seen[BDRCANLib::MESSAGE_COUNT] = {};
+        uint64_t nextSnapshotUs = 0;
+        bool started = false;
+        bool changed = false;       // latest[] holds values no snapshot has written yet
+        uint64_t lastUs = 0;
+
+        if (snapshotUs > 0) writer.writeSnapshotHeader();
+        else writer.writeFrameHeader();
+
+        while (log.next(all, cursor, record)) {
+            frames++;
+            if (record.flags & LOG_FLAG_EXTENDED) continue;
+            msg.id = record.id;
+            msg.length = (record.length > 8) ? 8 : record.length;
+            memcpy(msg.data, record.data, 8);
+
+            // Fields past a short frame's DLC are not decoded, so they keep their last snapshot value
+            int count = lib.decodeFrame(msg, values, BDRCANLib::MAX_SIGNALS_PER_ID);
+            if (count == 0) continue;
+            const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(msg.id));
+
+            if (snapshotUs == 0) {
+                writer.writeFrame(record.timestampUs, msg.id, defs, values, count);
+                continue;
+            }
+
+            if (!started) {
+                nextSnapshotUs = record.timestampUs + snapshotUs;
+                started = true;
+            }
+            while (record.timestampUs >= nextSnapshotUs) {
+                writer.writeSnapshot(nextSnapshotUs, latest, seen);
+                nextSnapshotUs += snapshotUs;
+                changed = false;
+            }
+            for (int i = 0; i < count; i++) {
+                int index = BDRCANLib::findMessageIndex(defs[i]);
+                latest[index] = values[i];
+                seen[index] = true;
+            }
+            changed = true;
+            lastUs = record.timestampUs;
+        }
+        // The state at the end of the log, unless the last snapshot already has it
+        if (changed) writer.writeSnapshot(lastUs, latest, seen);
+
+        ok = writer.close();
+        const ExportStats& stats = writer.getStats();
+        rows = stats.rows;
+        bytes = stats.bytes;
+        writes = stats.writes;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu frames, %llu rows, %.1f MB in %.3f s, %.1f MB/s, %llu writes\n",
+            (unsigned long long)frames, (unsigned long long)rows, bytes / 1e6, seconds,
+            seconds > 0 ? bytes / seconds / 1e6 : 0.0, (unsigned long long)writes);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include "Arduino.h"
+#include "ACAN_T4.h"
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+
+ACAN_T4 ACAN_T4::can1;
+ACAN_T4 ACAN_T4::can2;
+ACAN_T4 ACAN_T4::can3;
+
+static const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+static bool simulatedClock = false;
+static uint64_t simulatedUs = 0;
+
+void setHostClock(uint64_t nowUs) {
+    simulatedUs = nowUs;
+    simulatedClock = true;
+}
+
+uint32_t micros() {
+    // Truncating to 32 bits gives the same wrap as the Teensy counter
+    if (simulatedClock) return (uint32_t)simulatedUs;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - START).count();
+}
+
+uint32_t millis() {
+    if (simulatedClock) return (uint32_t)(simulatedUs / 1000);
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - START).count();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+long random(long max) {
+    return (max > 0) ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+    return (max > min) ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+    srand((unsigned)seed);
+}
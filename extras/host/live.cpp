@@ -0,0 +1,155 @@
+/*
+    live.cpp - bdrcan-live: decode a live SocketCAN interface (a car gateway, or vcan on a PC).
+
+      bdrcan-live <interface> [-f all|inverter|bms] [-q ms] [-n frames] [-s name]
+
+    Every inverter frame is decoded with the library and printed as CSV with the kernel
+    receive time: time_s,id,signal,value,units. With -q, every BMS PID is requested in turn
+    through sendOBD2Request and the answers are reassembled by BDRCANIsoTp. With -s, values
+    are published to a shared-memory snapshot (bdrcanshm.h) for other processes instead of
+    printed. Socket counters go to stderr on exit (Ctrl-C, or after -n frames).
+    */
+
+#include "Arduino.h"
+#include "bdrcanisotp.h"
+#include "bdrcanlib.h"
+#include "bdrcanshm.h"
+#include "bdrcansocketcan.h"
+#include <signal.h>
+#include <string>
+#include <vector>
+
+static volatile sig_atomic_t stopping = 0;
+
+static void onSignal(int) {
+    stopping = 1;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-live <interface> [-f all|inverter|bms] [-q ms] [-n frames] [-s name]\n"
+            "  -f  kernel filter from the signal table (default all)\n"
+            "  -q  request the next BMS PID every ms, 0 = no polling (default 0)\n"
+            "  -n  stop after this many frames (default: run until Ctrl-C)\n"
+            "  -s  publish to this shared-memory snapshot (e.g. /bdrcan) instead of printing\n");
+}
+
+static uint64_t frameTimeNs = 0;
+static SnapshotPublisher snapshot;
+
+static void printValue(const CanMessage& definition, uint32_t id, float value) {
+    printf("%llu.%09llu,0x%X,%s,%g,%s\n", (unsigned long long)(frameTimeNs / 1000000000ULL),
+           (unsigned long long)(frameTimeNs % 1000000000ULL), id, definition.name, value, definition.units);
+}
+
+static void onResponse(const OBD2Response& response, void*) {
+    if (response.definition == nullptr) return;
+    if (snapshot.isOpen()) {
+        snapshot.publishResponse(frameTimeNs / 1000, response);
+        return;
+    }
+    for (int i = 0; i < response.count; i++) printValue(*response.definition, response.pid, response.values[i]);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    const char* interface = argv[1];
+    uint8_t filter = SocketCANBackend::FILTER_ALL;
+    uint32_t pollMs = 0;
+    uint64_t maxFrames = 0;
+    const char* snapshotName = nullptr;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "-f" && value == "all") {
+            filter = SocketCANBackend::FILTER_ALL;
+        } else if (arg == "-f" && value == "inverter") {
+            filter = SocketCANBackend::FILTER_INVERTER;
+        } else if (arg == "-f" && value == "bms") {
+            filter = SocketCANBackend::FILTER_BMS;
+        } else if (arg == "-q") {
+            pollMs = (uint32_t)atoi(value.c_str());
+        } else if (arg == "-n") {
+            maxFrames = strtoull(value.c_str(), nullptr, 0);
+        } else if (arg == "-s") {
+            snapshotName = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    SocketCANBackend socket;
+    if (!socket.open(interface) || !socket.setFilter(filter)) return 1;
+    if (snapshotName != nullptr && !snapshot.open(snapshotName)) return 1;
+
+    // One interface carries both devices here: can1 for the inverter, can2 for OBD2 / ISO-TP
+    ACAN_T4::can1.setBackend(&socket);
+    ACAN_T4::can2.setBackend(&socket);
+
+    BDRCANLib lib;
+    BDRCANIsoTp isotp(ACAN_T4::can2);
+    isotp.onResponse(onResponse);
+
+    std::vector<uint16_t> pids;
+    for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+        const CanMessage* first = BDRCANLib::getSlotMessages(slot)[0];
+        if (BDRCANLib::isBMSMessage(first)) pids.push_back((uint16_t)first->id);
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    if (!snapshot.isOpen()) printf("time_s,id,signal,value,units\n");
+    uint64_t frames = 0;
+    size_t nextPid = 0;
+    uint32_t lastPollMs = millis();
+    float values[BDRCANLib::MAX_SIGNALS_PER_ID];
+
+    while (!stopping && (maxFrames == 0 || frames < maxFrames)) {
+        socket.wait(pollMs ? (int)pollMs : 100);
+
+        CANMessage frame;
+        while (socket.receive(frame, frameTimeNs)) {
+            frames++;
+            // The table and the ISO-TP IDs are standard data frames; an extended 0x20 is not ERPM
+            if (frame.ext || frame.rtr) continue;
+            if (isotp.handleFrame(frame)) continue;
+
+            messageStruct msg = lib.createMessageInv(frame.id, frame.data, frame.len);
+            int count;
+            const CanMessage* const* defs = BDRCANLib::getSlotMessages(BDRCANLib::findSlotByID(frame.id), &count);
+            // Only the fields the DLC carries: a short frame leaves the snapshot's older values alone
+            int decoded = (defs != nullptr) ? lib.decodeFrame(msg, values, BDRCANLib::MAX_SIGNALS_PER_ID) : 0;
+            if (snapshot.isOpen()) snapshot.publishFrame(frameTimeNs / 1000, defs, values, decoded);
+            else for (int i = 0; i < decoded; i++) printValue(*defs[i], frame.id, values[i]);
+            if (maxFrames != 0 && frames >= maxFrames) break;
+        }
+        isotp.update();
+
+        if (pollMs != 0 && !pids.empty() && millis() - lastPollMs >= pollMs) {
+            lastPollMs = millis();
+            lib.sendOBD2Request(pids[nextPid]);
+            nextPid = (nextPid + 1) % pids.size();
+        }
+    }
+
+    socket.flush();
+    const SocketCANStats& s = socket.getStats();
+    fprintf(stderr, "%llu frames received in %llu batches, %llu sent, %u kernel drops, %u send retries, %u errors\n",
+            (unsigned long long)s.received, (unsigned long long)s.receiveCalls, (unsigned long long)s.sent,
+            s.kernelDrops, s.sendBusy, s.errors);
+
+    snapshot.close();
+    ACAN_T4::can1.setBackend(nullptr);
+    ACAN_T4::can2.setBackend(nullptr);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+    logindex.cpp - bdrcan-index: build a log's sidecar index and run indexed queries.
+
+      bdrcan-index build <log> [-b records]
+      bdrcan-index query <log> [--from us] [--to us] [--id 0x20] [--id 0xF100-0xF10E]
+      bdrcan-index seek <log> <us>
+
+    The index lives next to the log as <log>.idx. query and seek build it first if it is
+    missing or was made for a different version of the log or by a build with another signal
+    table (see BDRCAN_PROFILE).
+    */
+
+#include "bdrcanindex.h"
+#include "bdrcanlog.h"
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-index build <log> [-b records]\n"
+            "       bdrcan-index query <log> [--from us] [--to us] [--id ID] [--id FIRST-LAST]\n"
+            "       bdrcan-index seek <log> <us>\n");
+}
+
+static bool loadIndex(const LogFile& log, const std::string& path, LogIndex& index) {
+    if (index.open(path.c_str(), log.size())) return true;
+
+    fprintf(stderr, "bdrcan-index: building %s\n", path.c_str());
+    index.build(log);
+    if (!index.save(path.c_str(), log.size())) {
+        fprintf(stderr, "bdrcan-index: cannot write %s (using the index in memory)\n", path.c_str());
+    }
+    return true;
+}
+
+static void printRecord(const LogRecord& record) {
+    printf("(%llu.%06llu) can%u %0*X#", (unsigned long long)(record.timestampUs / 1000000),
+           (unsigned long long)(record.timestampUs % 1000000), record.channel,
+           (record.flags & LOG_FLAG_EXTENDED) ? 8 : 3, record.id);
+    for (int i = 0; i < record.length && i < 8; i++) printf("%02X", record.data[i]);
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    std::string command = argv[1];
+    std::string logPath = argv[2];
+    std::string indexPath = logPath + ".idx";
+
+    LogFile log;
+    if (!log.open(logPath.c_str())) {
+        fprintf(stderr, "bdrcan-index: cannot read %s\n", logPath.c_str());
+        return 1;
+    }
+
+    if (command == "build") {
+        uint32_t recordsPerBlock = LogIndexBuilder::DEFAULT_RECORDS_PER_BLOCK;
+        if (argc >= 5 && std::string(argv[3]) == "-b") recordsPerBlock = (uint32_t)atol(argv[4]);
+
+        LogIndex index;
+        index.build(log, recordsPerBlock);
+        if (!index.save(indexPath.c_str(), log.size())) {
+            fprintf(stderr, "bdrcan-index: cannot write %s\n", indexPath.c_str());
+            return 1;
+        }
+        fprintf(stderr, "%zu blocks\n", index.blockCount());
+        return 0;
+    }
+
+    LogIndex index;
+    loadIndex(log, indexPath, index);
+
+    if (command == "seek" && argc >= 4) {
+        uint64_t offset = index.seek(strtoull(argv[3], nullptr, 10));
+        printf("%llu\n", (unsigned long long)offset);
+        return 0;
+    }
+
+    if (command != "query") {
+        usage();
+        return 2;
+    }
+
+    uint64_t fromUs = 0;
+    uint64_t toUs = UINT64_MAX;
+    IdFilter ids;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        const char* value = argv[i + 1];
+        if (arg == "--from") {
+            fromUs = strtoull(value, nullptr, 10);
+        } else if (arg == "--to") {
+            toUs = strtoull(value, nullptr, 10);
+        } else if (arg == "--id") {
+            char* end;
+            uint32_t first = (uint32_t)strtoul(value, &end, 16);
+            uint32_t last = (*end == '-') ? (uint32_t)strtoul(end + 1, nullptr, 16) : first;
+            ids.addRange(first, last);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<LogChunk> chunks = index.select(ids, fromUs, toUs);
+    uint64_t scanned = 0;
+    uint64_t matched = 0;
+    LogRecord record;
+    for (const LogChunk& chunk : chunks) {
+        scanned += chunk.end - chunk.begin;
+        size_t cursor = chunk.begin;
+        while (log.next(chunk, cursor, record)) {
+            if (record.timestampUs < fromUs || record.timestampUs > toUs || !ids.matches(record.id)) continue;
+            printRecord(record);
+            matched++;
+        }
+    }
+
+    fprintf(stderr, "%llu records, %zu ranges, %llu of %zu bytes scanned\n", (unsigned long long)matched,
+            chunks.size(), (unsigned long long)scanned, log.size());
+    return 0;
+}
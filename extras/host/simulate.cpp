@@ -0,0 +1,300 @@
+/*
+    simulate.cpp - bdrcan-sim: load test the library against simulated inverter and BMS traffic.
+
+    The inverter broadcasts on can1 and the BMS answers on can2, both SimBus backends. The
+    node under test is a sketch loop built from the library: BDRCANDispatcher decodes every
+    inverter frame, sendOBD2Request polls every BMS PID in turn through a BDRCANTxQueue, and
+    BDRCANIsoTp reassembles the answers. At the end the bus, BMS and node counters are printed.
+
+    Simulated time follows the wall clock (times -x), or with -x 0 advances a fixed step per
+    loop pass, as fast as the host runs and the same on every run. The node reads it too:
+    millis() / micros() return the simulated time (setHostClock), so ISO-TP timeouts and
+    queue waits run at the same speed as the buses.
+    */
+
+#include "Arduino.h"
+#include "bdrcandispatch.h"
+#include "bdrcanisotp.h"
+#include "bdrcansim.h"
+#include "bdrcantxqueue.h"
+#include <chrono>
+#include <string>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-sim [options]\n"
+            "  -d seconds      simulated run time (default 10)\n"
+            "  -x speed        simulated seconds per wall second; 0 = fixed steps, unpaced (default 1)\n"
+            "  -s us           step per loop pass with -x 0, i.e. the node's loop time (default 100)\n"
+            "  -b bitrate      both buses, bit/s (default 1000000)\n"
+            "  -p ms           inverter broadcast period of every ID (default 10)\n"
+            "  -P id=ms        period of one ID, 0 stops it\n"
+            "  -l percent      inverter bus load to aim for; sets the period of every ID\n"
+            "  -w name=shape[:low[:high[:period]]]\n"
+            "                  waveform of a signal (name or alt); shapes constant sine ramp square noise\n"
+            "  -q ms           gap between BMS requests (default 0: next PID once answered)\n"
+            "  -r us           BMS response delay (default 1000)\n"
+            "  --rx-depth n    receive FIFO frames per bus (default 64)\n"
+            "  --drop rate     frames lost on the wire (0..1)\n"
+            "  --error rate    error frames + retransmission (0..1)\n"
+            "  --bms-silent rate, --bms-negative rate, --isotp-drop rate\n"
+            "                  unanswered requests, 0x7F answers, consecutive frames withheld\n"
+            "  --fault code@start+seconds\n"
+            "                  broadcast fault_code = code during the window\n");
+}
+
+// The sketch under test
+struct Node {
+    static const uint32_t RESPONSE_TIMEOUT_US = 100000;
+
+    BDRCANDispatcher dispatcher;
+    BDRCANLib lib;
+    BDRCANIsoTp isotp;
+    BDRCANTxQueue bmsTx;
+    std::vector<uint16_t> pids;
+
+    uint64_t inverterFrames = 0;
+    uint64_t decodedSignals = 0;
+    uint64_t requests = 0;
+    uint64_t responses = 0;
+    uint64_t unanswered = 0;
+    double totalRoundTripUs = 0;
+    double maxRoundTripUs = 0;
+
+    size_t nextPid = 0;
+    bool awaiting = false;
+    double requestUs = 0;
+    double nowUs = 0;
+
+    Node() : isotp(ACAN_T4::can2), bmsTx(ACAN_T4::can2) {
+        dispatcher.onDevice(BDRCANDispatcher::DEVICE_INVERTER, onInverter, this);
+        isotp.onResponse(onResponse, this);
+        lib.setTxQueue(&bmsTx);
+        for (int slot = 0; slot < BDRCANLib::getSlotCount(); slot++) {
+            const CanMessage* first = BDRCANLib::getSlotMessages(slot)[0];
+            if (BDRCANLib::isBMSMessage(first)) pids.push_back((uint16_t)first->id);
+        }
+    }
+
+    static void onInverter(const messageStruct&, const DecodedFrame& frame, void* context) {
+        Node* node = (Node*)context;
+        node->inverterFrames++;
+        node->decodedSignals += frame.count;
+    }
+
+    static void onResponse(const OBD2Response&, void* context) {
+        Node* node = (Node*)context;
+        if (!node->awaiting) return;
+        double roundTripUs = node->nowUs - node->requestUs;
+        node->responses++;
+        node->totalRoundTripUs += roundTripUs;
+        if (roundTripUs > node->maxRoundTripUs) node->maxRoundTripUs = roundTripUs;
+        node->awaiting = false;
+    }
+
+    // One pass of loop()
+    void poll(double nowUs, uint32_t requestGapUs) {
+        this->nowUs = nowUs;
+        CANMessage frame;
+        while (ACAN_T4::can1.receive(frame)) {
+            messageStruct msg;
+            msg.id = frame.id;
+            msg.length = frame.len;
+            memcpy(msg.data, frame.data, sizeof(msg.data));
+            dispatcher.dispatch(msg);
+        }
+        while (ACAN_T4::can2.receive(frame)) isotp.handleFrame(frame);
+        isotp.update();
+
+        if (awaiting && nowUs - requestUs > RESPONSE_TIMEOUT_US) {
+            unanswered++;
+            awaiting = false;
+        }
+        if (!awaiting && !pids.empty() && nowUs - requestUs >= requestGapUs) {
+            lib.sendOBD2Request(pids[nextPid]);
+            nextPid = (nextPid + 1) % pids.size();
+            requests++;
+            awaiting = true;
+            requestUs = nowUs;
+        }
+        bmsTx.update((uint32_t)nowUs);
+    }
+};
+
+static int findSignal(const char* name) {
+    const CanMessage* msg = BDRCANLib::findMessageByName(name);
+    if (msg == nullptr) msg = BDRCANLib::findMessageByAlt(name);
+    return (msg == nullptr) ? -1 : BDRCANLib::findMessageIndex(msg);
+}
+
+static void printBus(const char* name, const SimBus& bus) {
+    const SimBusStats& s = bus.getStats();
+    printf("%-9s %9llu %6.1f %9llu %8llu %7llu %8llu %8llu %5u %7.0f %7.0f %8.0f\n", name,
+           (unsigned long long)s.frames, s.elapsedUs > 0 ? 100.0 * s.busyUs / s.elapsedUs : 0.0,
+           (unsigned long long)s.delivered, (unsigned long long)s.dropped, (unsigned long long)s.errors,
+           (unsigned long long)s.overruns, (unsigned long long)s.txRejected, s.maxRxDepth,
+           bus.latencyUs(0.50), bus.latencyUs(0.99), bus.maxLatencyUs());
+}
+
+int main(int argc, char** argv) {
+    double seconds = 10;
+    double speed = 1;
+    double stepUs = 100;
+    uint32_t bitrate = 1000000;
+    uint32_t periodUs = 10000;
+    double loadPercent = 0;
+    uint32_t requestGapUs = 0;
+    uint32_t responseDelayUs = 1000;
+    int rxDepth = 64;
+    SimFaults faults;
+    std::vector<std::pair<uint32_t, uint32_t> > idPeriods;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (arg == "-d") {
+            seconds = atof(value);
+        } else if (arg == "-x") {
+            speed = atof(value);
+        } else if (arg == "-s") {
+            stepUs = atof(value);
+        } else if (arg == "-b") {
+            bitrate = strtoul(value, nullptr, 0);
+        } else if (arg == "-p") {
+            periodUs = (uint32_t)(atof(value) * 1000);
+        } else if (arg == "-P") {
+            const char* equals = strchr(value, '=');
+            if (equals == nullptr) {
+                usage();
+                return 2;
+            }
+            idPeriods.push_back({(uint32_t)strtoul(value, nullptr, 0), (uint32_t)(atof(equals + 1) * 1000)});
+        } else if (arg == "-l") {
+            loadPercent = atof(value);
+        } else if (arg == "-w") {
+            std::string spec = value;
+            size_t equals = spec.find('=');
+            int index = (equals == std::string::npos) ? -1 : findSignal(spec.substr(0, equals).c_str());
+            if (index < 0 || !simWaveform(index).parse(spec.c_str() + equals + 1)) {
+                fprintf(stderr, "bdrcan-sim: bad waveform %s\n", value);
+                return 2;
+            }
+        } else if (arg == "-q") {
+            requestGapUs = (uint32_t)(atof(value) * 1000);
+        } else if (arg == "-r") {
+            responseDelayUs = strtoul(value, nullptr, 0);
+        } else if (arg == "--rx-depth") {
+            rxDepth = atoi(value);
+        } else if (arg == "--drop") {
+            faults.dropRate = atof(value);
+        } else if (arg == "--error") {
+            faults.errorRate = atof(value);
+        } else if (arg == "--bms-silent") {
+            faults.bmsSilentRate = atof(value);
+        } else if (arg == "--bms-negative") {
+            faults.bmsNegativeRate = atof(value);
+        } else if (arg == "--isotp-drop") {
+            faults.isotpDropRate = atof(value);
+        } else if (arg == "--fault") {
+            int code;
+            if (sscanf(value, "%i@%lf+%lf", &code, &faults.faultStartS, &faults.faultDurationS) != 3) {
+                usage();
+                return 2;
+            }
+            faults.faultCode = (uint16_t)code;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (bitrate == 0 || rxDepth < 1 || seconds <= 0 || speed < 0 || stepUs <= 0) {
+        usage();
+        return 2;
+    }
+
+    SimBus inverterBus(bitrate, rxDepth);
+    SimBus bmsBus(bitrate, rxDepth);
+    inverterBus.setFaults(&faults, 11);
+    bmsBus.setFaults(&faults, 12);
+    ACAN_T4::can1.setBackend(&inverterBus);
+    ACAN_T4::can2.setBackend(&bmsBus);
+
+    InverterSim inverter(inverterBus);
+    BMSSim bms(bmsBus);
+    inverter.setFaults(&faults);
+    bms.setFaults(&faults);
+    bms.setResponseDelay(responseDelayUs);
+
+    if (loadPercent > 0) {
+        periodUs = (uint32_t)(inverter.cycleUs() * 100.0 / loadPercent);
+    }
+    inverter.setPeriod(periodUs);
+    for (const auto& p : idPeriods) {
+        if (!inverter.setPeriod(p.first, p.second)) {
+            fprintf(stderr, "bdrcan-sim: 0x%X is not an inverter broadcast ID\n", p.first);
+            return 2;
+        }
+    }
+
+    Node node;
+    const double endUs = seconds * 1e6;
+    double nowUs = 0;
+    uint64_t passes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (nowUs < endUs) {
+        if (speed > 0) {
+            double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            nowUs = wallUs * speed;
+        } else {
+            nowUs += stepUs;
+        }
+        if (nowUs > endUs) nowUs = endUs;
+        setHostClock((uint64_t)nowUs);
+
+        inverter.update(nowUs);
+        bms.update(nowUs);
+        inverterBus.run(nowUs);
+        bmsBus.run(nowUs);
+        node.poll(nowUs, requestGapUs);
+        passes++;
+    }
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%.3f s simulated in %.3f s, %u bit/s, %d inverter IDs every %.2f ms, %llu loop passes\n\n",
+           seconds, wallS, bitrate, inverter.idCount(), periodUs / 1000.0, (unsigned long long)passes);
+    printf("%-9s %9s %6s %9s %8s %7s %8s %8s %5s %7s %7s %8s\n", "bus", "frames", "load%", "received",
+           "dropped", "errors", "overruns", "rejected", "rxmax", "p50 us", "p99 us", "max us");
+    printBus("inverter", inverterBus);
+    printBus("bms", bmsBus);
+
+    const BMSSimStats& b = bms.getStats();
+    printf("\nBMS: %u requests, %u answered (%u multi-frame), %u negative, %u silent, "
+           "%u consecutive frames withheld, %u flow control timeouts\n",
+           b.requests, b.responses, b.multiFrame, b.negative, b.silent, b.consecutiveDropped,
+           b.flowControlTimeouts);
+
+    const IsoTpStats& t = node.isotp.getStats();
+    printf("node: %llu inverter frames (%llu signals), %llu requests, %llu responses, %llu unanswered, "
+           "round trip avg %.0f us max %.0f us\n",
+           (unsigned long long)node.inverterFrames, (unsigned long long)node.decodedSignals,
+           (unsigned long long)node.requests, (unsigned long long)node.responses,
+           (unsigned long long)node.unanswered,
+           node.responses ? node.totalRoundTripUs / node.responses : 0.0, node.maxRoundTripUs);
+    printf("ISO-TP: %u completed, %u negative, %u sequence errors, %u timeouts, %u overflows, "
+           "%u flow control retries\n",
+           t.completed, t.negative, t.sequenceErrors, t.timeouts, t.overflows, t.flowControlRetries);
+
+    TxClassStats q;
+    node.bmsTx.getStats(TX_POLLING, q);
+    printf("poll queue: %u queued, %u sent, %u coalesced, %u dropped, %u retries, max wait %u us\n",
+           q.queued, q.sent, q.coalesced, q.dropped, q.retries, q.maxWaitUs);
+
+    ACAN_T4::can1.setBackend(nullptr);
+    ACAN_T4::can2.setBackend(nullptr);
+    return 0;
+}
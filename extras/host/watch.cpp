@@ -0,0 +1,107 @@
+/*
+    watch.cpp - bdrcan-watch: read signals from a shared-memory snapshot published by bdrcan-live.
+
+      bdrcan-watch [-s name] [-i ms] [-n rows] <signal>...
+      bdrcan-watch [-s name] --list
+
+    Prints one CSV row per interval with a consistent set of the named signals (empty until a
+    signal is first published). Reads are plain loads from the mapped segment; the process
+    makes no system call per read and never slows the publisher down.
+    */
+
+#include "bdrcanshm.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+static void usage() {
+    fprintf(stderr,
+            "usage: bdrcan-watch [-s name] [-i ms] [-n rows] <signal>...\n"
+            "       bdrcan-watch [-s name] --list\n"
+            "  -s  shared-memory snapshot (default /bdrcan)\n"
+            "  -i  print interval in ms (default 100)\n"
+            "  -n  stop after this many rows (default: until the publisher exits)\n"
+            "  <signal> is a signal name or alt name\n");
+}
+
+static void listSignals(const SnapshotReader& reader) {
+    printf("index,id,signal,alt,units,elements,updated_us\n");
+    for (int i = 0; i < reader.signalCount(); i++) {
+        const SnapshotSignal& s = reader.signal(i);
+        printf("%d,0x%X,%s,%s,%s,%u,%llu\n", i, s.id, s.name, s.alt, s.units, s.elements,
+               (unsigned long long)reader.timestampUs(i));
+    }
+    fprintf(stderr, "%llu publishes, %s table\n", (unsigned long long)reader.publishes(),
+            reader.sameTable() ? "same" : "different");
+}
+
+int main(int argc, char** argv) {
+    const char* name = SnapshotPublisher::DEFAULT_NAME;
+    long intervalMs = 100;
+    uint64_t maxRows = 0;
+    bool list = false;
+    std::vector<const char*> names;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-s" && hasValue) name = argv[++i];
+        else if (arg == "-i" && hasValue) intervalMs = atol(argv[++i]);
+        else if (arg == "-n" && hasValue) maxRows = strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--list") list = true;
+        else if (arg[0] != '-') names.push_back(argv[i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (names.empty() && !list) {
+        usage();
+        return 2;
+    }
+
+    SnapshotReader reader;
+    if (!reader.open(name)) {
+        fprintf(stderr, "bdrcan-watch: no snapshot at %s\n", name);
+        return 1;
+    }
+    if (list) {
+        listSignals(reader);
+        return 0;
+    }
+
+    std::vector<int> indices;
+    printf("last_us");
+    for (const char* signal : names) {
+        int index = reader.findSignal(signal);
+        if (index < 0) {
+            fprintf(stderr, "bdrcan-watch: unknown signal %s\n", signal);
+            return 2;
+        }
+        indices.push_back(index);
+        const SnapshotSignal& s = reader.signal(index);
+        printf(s.units[0] != '\0' ? ",%s %s" : ",%s", s.name, s.units);
+    }
+    printf("\n");
+
+    std::vector<float> values(indices.size());
+    struct timespec interval = {intervalMs / 1000, (intervalMs % 1000) * 1000000};
+    for (uint64_t row = 0; (maxRows == 0 || row < maxRows) && reader.isLive(); row++) {
+        if (!reader.read(indices.data(), (int)indices.size(), values.data())) {
+            fprintf(stderr, "bdrcan-watch: publisher stuck mid-write\n");
+            return 1;
+        }
+        printf("%llu", (unsigned long long)reader.lastUs());
+        for (float value : values) {
+            if (isnan(value)) printf(",");
+            else printf(",%g", value);
+        }
+        printf("\n");
+        fflush(stdout);
+        nanosleep(&interval, nullptr);
+    }
+    return 0;
+}
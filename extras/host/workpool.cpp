@@ -0,0 +1,87 @@
+#include "workpool.h"
+
+WorkPool::WorkPool(int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    for (int i = 0; i < threads; i++) queues.emplace_back(new Queue());
+    for (int i = 0; i < threads; i++) workers.emplace_back(&WorkPool::run, this, i);
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void WorkPool::submit(Task task) {
+    pending++;
+    Queue& queue = *queues[nextQueue++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Count under the state lock so a worker about to sleep cannot miss it
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+void WorkPool::wait() {
+    std::unique_lock<std::mutex> guard(stateLock);
+    idle.wait(guard, [this] { return pending.load() == 0; });
+}
+
+bool WorkPool::take(int self, Task& task) {
+    // Own deque first, oldest task first
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    // Then steal the newest task of another worker
+    int count = (int)queues.size();
+    for (int i = 1; i < count; i++) {
+        Queue& victim = *queues[(self + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            queued--;
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkPool::run(int self) {
+    Task task;
+    for (;;) {
+        if (take(self, task)) {
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> guard(stateLock);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(stateLock);
+        wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
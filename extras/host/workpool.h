@@ -0,0 +1,60 @@
+/*
+    workpool.h - Work-stealing thread pool for the host tools.
+
+    Every worker owns a deque. It takes its own tasks from the front and, when idle, steals
+    from the back of the others, so uneven chunks (bursty logs) keep all cores busy.
+    */
+
+    #ifndef workpool_h
+    #define workpool_h
+    #include <atomic>
+    #include <condition_variable>
+    #include <deque>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+
+    class WorkPool {
+    public:
+        typedef std::function<void()> Task;
+
+        // threads <= 0 uses every hardware thread
+        explicit WorkPool(int threads = 0);
+        ~WorkPool();
+
+        int threadCount() const { return (int)workers.size(); }
+
+        // Queue a task on the next worker's deque (round robin)
+        void submit(Task task);
+
+        // Block until every submitted task has finished
+        void wait();
+
+        // Tasks taken from another worker's deque since construction
+        uint64_t stealCount() const { return steals.load(); }
+
+    private:
+        struct Queue {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        void run(int self);
+        bool take(int self, Task& task);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+
+        std::mutex stateLock;
+        std::condition_variable wake;           // tasks queued or stopping
+        std::condition_variable idle;           // pending reached zero
+        std::atomic<int> queued{0};
+        std::atomic<int> pending{0};
+        std::atomic<uint64_t> steals{0};
+        unsigned nextQueue = 0;
+        bool stopping = false;
+    };
+
+#endif